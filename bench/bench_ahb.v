@@ -0,0 +1,196 @@
+// -----------------------------------------------------------------------------
+//  Title      : Benchmark driver for the AHB memory model wrapper
+//  Project    : UNKNOWN
+// -----------------------------------------------------------------------------
+//  File       : bench_ahb.v
+//  Author     : Simon Southwell
+//  Created    : 2026-10-18
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  Drives the benchmark traffic through mem_model_ahb, with pipelined
+//  zero wait state transfers. Single transfers are SINGLE bursts, and
+//  bursts are INCR4, INCR8 or INCR16 when BURST_LEN is 4, 8 or 16, else
+//  undefined length INCR. Inputs are driven on the falling edge of hclk.
+//  Each task leaves the data phase of its last write transfer to overlap
+//  the first address phase of the next.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2026 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation(), either version 3 of the License(), or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful(),
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+module bench_ahb
+#(parameter WORDS            = 65536,
+  parameter BURST_LEN        = 16)
+(
+  input                        clk,
+  input                        rst_n
+);
+
+localparam                     NAME = "ahb";
+
+localparam                     TRANS_IDLE   = 2'b00;
+localparam                     TRANS_NONSEQ = 2'b10;
+localparam                     TRANS_SEQ    = 2'b11;
+
+localparam                     BURST_SINGLE = 3'b000;
+localparam                     BURST_INCR   = (BURST_LEN ==  4) ? 3'b011 :
+                                              (BURST_LEN ==  8) ? 3'b101 :
+                                              (BURST_LEN == 16) ? 3'b111 :
+                                                                  3'b001;
+
+reg                            hsel;
+reg  [31:0]                    haddr;
+reg  [31:0]                    hwdata;
+reg                            hwrite;
+reg   [2:0]                    hburst;
+reg   [1:0]                    htrans;
+
+wire [31:0]                    hrdata;
+wire                           hready;
+wire                           hresp;
+
+integer                        beat;
+
+initial
+begin
+  hsel                         = 1'b0;
+  haddr                        = 32'h00000000;
+  hwdata                       = 32'h00000000;
+  hwrite                       = 1'b0;
+  hburst                       = BURST_SINGLE;
+  htrans                       = TRANS_IDLE;
+end
+
+// -----------------------------------------------
+// Wrapper transfer tasks
+// -----------------------------------------------
+
+task bench_align;
+begin
+  @(negedge clk);
+end
+endtask
+
+task bench_idle;
+begin
+  repeat (2) @(negedge clk);
+end
+endtask
+
+// Drive an address phase and wait for it to be sampled
+task addr_phase;
+  input [31:0] addr;
+  input        wnr;
+  input  [2:0] burst;
+  input  [1:0] trans;
+begin
+  hsel                        <= 1'b1;
+  haddr                       <= addr;
+  hwrite                      <= wnr;
+  hburst                      <= burst;
+  htrans                      <= trans;
+  @(negedge clk);
+end
+endtask
+
+task wr_single;
+  input [31:0] addr;
+  input [31:0] data;
+begin
+  addr_phase(addr, 1'b1, BURST_SINGLE, TRANS_NONSEQ);
+  htrans                      <= TRANS_IDLE;
+  hwdata                      <= data;
+end
+endtask
+
+task rd_single;
+  input  [31:0] addr;
+  output [31:0] data;
+begin
+  addr_phase(addr, 1'b0, BURST_SINGLE, TRANS_NONSEQ);
+  htrans                      <= TRANS_IDLE;
+  data                         = hrdata;
+end
+endtask
+
+// Each beat's data is driven with the following beat's address phase
+task wr_burst;
+  input [31:0] addr;
+  input [31:0] len;
+  input [31:0] seed;
+begin
+  for (beat = 0; beat < len; beat = beat + 1)
+  begin
+    if (beat != 0)
+    begin
+      hwdata                  <= pattern(addr + (beat-1)*4, seed);
+    end
+    addr_phase(addr + beat*4, 1'b1, BURST_INCR, (beat == 0) ? TRANS_NONSEQ : TRANS_SEQ);
+  end
+
+  htrans                      <= TRANS_IDLE;
+  hwdata                      <= pattern(addr + (len-1)*4, seed);
+end
+endtask
+
+task rd_burst;
+  input [31:0] addr;
+  input [31:0] len;
+  input [31:0] seed;
+begin
+  for (beat = 0; beat < len; beat = beat + 1)
+  begin
+    addr_phase(addr + beat*4, 1'b0, BURST_INCR, (beat == 0) ? TRANS_NONSEQ : TRANS_SEQ);
+    check(addr + beat*4, hrdata, pattern(addr + beat*4, seed));
+  end
+
+  htrans                      <= TRANS_IDLE;
+end
+endtask
+
+// -----------------------------------------------
+// Traffic sequence
+// -----------------------------------------------
+
+`include "bench_seq.vh"
+
+// -----------------------------------------------
+// AHB memory model
+// -----------------------------------------------
+
+  mem_model_ahb mem
+  (
+    .hclk                   (clk),
+    .hresetn                (rst_n),
+
+    .hsel                   (hsel),
+    .haddr                  (haddr),
+    .hwdata                 (hwdata),
+    .hwrite                 (hwrite),
+    .hburst                 (hburst),
+    .hsize                  (3'b010),
+    .htrans                 (htrans),
+    .hmastlock              (1'b0),
+    .hwstrb                 (4'hf),
+
+    .hrdata                 (hrdata),
+    .hready                 (hready),
+    .hresp                  (hresp)
+  );
+
+endmodule
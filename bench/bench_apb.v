@@ -0,0 +1,180 @@
+// -----------------------------------------------------------------------------
+//  Title      : Benchmark driver for the APB memory model wrapper
+//  Project    : UNKNOWN
+// -----------------------------------------------------------------------------
+//  File       : bench_apb.v
+//  Author     : Simon Southwell
+//  Created    : 2026-10-18
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  Drives the benchmark traffic through mem_model_apb. APB has no bursts,
+//  so bursts are issued as back to back transfers, each with a setup and
+//  an access phase. Inputs are driven on the rising edge of pclk, and
+//  pready and prdata sampled on the falling edge of the access phase.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2026 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation(), either version 3 of the License(), or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful(),
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+module bench_apb
+#(parameter WORDS            = 65536,
+  parameter BURST_LEN        = 16)
+(
+  input                        clk,
+  input                        rst_n
+);
+
+localparam                     NAME = "apb";
+
+reg                            psel;
+reg  [31:0]                    paddr;
+reg  [31:0]                    pwdata;
+reg                            pwrite;
+reg                            penable;
+
+wire [31:0]                    prdata;
+wire                           pready;
+wire                           pslverr;
+
+integer                        beat;
+reg  [31:0]                    rdata_b;
+
+initial
+begin
+  psel                         = 1'b0;
+  paddr                        = 32'h00000000;
+  pwdata                       = 32'h00000000;
+  pwrite                       = 1'b0;
+  penable                      = 1'b0;
+end
+
+// -----------------------------------------------
+// Wrapper transfer tasks
+// -----------------------------------------------
+
+task bench_align;
+begin
+  @(posedge clk);
+end
+endtask
+
+task bench_idle;
+begin
+  repeat (2) @(posedge clk);
+end
+endtask
+
+// A setup phase followed by an access phase, extended until pready
+task apb_xfer;
+  input  [31:0] addr;
+  input         wnr;
+  input  [31:0] wdata;
+  output [31:0] rdata;
+begin
+  psel                        <= 1'b1;
+  penable                     <= 1'b0;
+  paddr                       <= addr;
+  pwrite                      <= wnr;
+  pwdata                      <= wdata;
+  @(posedge clk);
+
+  penable                     <= 1'b1;
+  @(negedge clk);
+  while (pready !== 1'b1)
+  begin
+    @(negedge clk);
+  end
+
+  rdata                        = prdata;
+  @(posedge clk);
+
+  psel                        <= 1'b0;
+  penable                     <= 1'b0;
+end
+endtask
+
+task wr_single;
+  input [31:0] addr;
+  input [31:0] data;
+begin
+  apb_xfer(addr, 1'b1, data, rdata_b);
+end
+endtask
+
+task rd_single;
+  input  [31:0] addr;
+  output [31:0] data;
+begin
+  apb_xfer(addr, 1'b0, 32'h00000000, data);
+end
+endtask
+
+task wr_burst;
+  input [31:0] addr;
+  input [31:0] len;
+  input [31:0] seed;
+begin
+  for (beat = 0; beat < len; beat = beat + 1)
+  begin
+    apb_xfer(addr + beat*4, 1'b1, pattern(addr + beat*4, seed), rdata_b);
+  end
+end
+endtask
+
+task rd_burst;
+  input [31:0] addr;
+  input [31:0] len;
+  input [31:0] seed;
+begin
+  for (beat = 0; beat < len; beat = beat + 1)
+  begin
+    apb_xfer(addr + beat*4, 1'b0, 32'h00000000, rdata_b);
+    check(addr + beat*4, rdata_b, pattern(addr + beat*4, seed));
+  end
+end
+endtask
+
+// -----------------------------------------------
+// Traffic sequence
+// -----------------------------------------------
+
+`include "bench_seq.vh"
+
+// -----------------------------------------------
+// APB memory model
+// -----------------------------------------------
+
+  mem_model_apb mem
+  (
+    .pclk                   (clk),
+    .presetn                (rst_n),
+
+    .psel                   (psel),
+    .paddr                  (paddr),
+    .pwdata                 (pwdata),
+    .pwrite                 (pwrite),
+    .penable                (penable),
+    .pstrb                  (4'hf),
+    .pprot                  (3'b000),
+
+    .prdata                 (prdata),
+    .pready                 (pready),
+    .pslverr                (pslverr)
+  );
+
+endmodule
@@ -0,0 +1,231 @@
+// -----------------------------------------------------------------------------
+//  Title      : Benchmark driver for the AXI memory model wrapper
+//  Project    : UNKNOWN
+// -----------------------------------------------------------------------------
+//  File       : bench_axi.v
+//  Author     : Simon Southwell
+//  Created    : 2026-10-18
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  Drives the benchmark traffic through mem_model_axi. Reads are issued
+//  as AXI bursts of the requested length. The wrapper takes one write
+//  data beat per write address, so write bursts are issued as back to
+//  back single beat writes, with address and data presented together.
+//  Inputs are driven on the falling edge of clk, and responses are always
+//  accepted (bready and rready high).
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2026 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation(), either version 3 of the License(), or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful(),
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+module bench_axi
+#(parameter WORDS            = 65536,
+  parameter BURST_LEN        = 16)
+(
+  input                        clk,
+  input                        rst_n
+);
+
+localparam                     NAME = "axi";
+
+reg  [31:0]                    awaddr;
+reg                            awvalid;
+wire                           awready;
+reg   [7:0]                    awlen;
+
+reg  [31:0]                    wdata;
+reg                            wvalid;
+wire                           wready;
+
+wire                           bvalid;
+
+reg  [31:0]                    araddr;
+reg                            arvalid;
+wire                           arready;
+reg   [7:0]                    arlen;
+
+wire [31:0]                    rdata;
+wire                           rvalid;
+wire                           rlast;
+
+integer                        beat;
+
+initial
+begin
+  awaddr                       = 32'h00000000;
+  awvalid                      = 1'b0;
+  awlen                        = 8'h00;
+  wdata                        = 32'h00000000;
+  wvalid                       = 1'b0;
+  araddr                       = 32'h00000000;
+  arvalid                      = 1'b0;
+  arlen                        = 8'h00;
+end
+
+// -----------------------------------------------
+// Wrapper transfer tasks
+// -----------------------------------------------
+
+task bench_align;
+begin
+  @(negedge clk);
+end
+endtask
+
+task bench_idle;
+begin
+  repeat (4) @(negedge clk);
+end
+endtask
+
+// The wrapper queues an address or data whenever valid is high, so
+// valid is only raised for a single cycle when there's room
+task wr_single;
+  input [31:0] addr;
+  input [31:0] data;
+begin
+  while (awready == 1'b0 || wready == 1'b0)
+  begin
+    @(negedge clk);
+  end
+
+  awaddr                      <= addr;
+  awlen                       <= 8'h00;
+  awvalid                     <= 1'b1;
+  wdata                       <= data;
+  wvalid                      <= 1'b1;
+  @(negedge clk);
+  awvalid                     <= 1'b0;
+  wvalid                      <= 1'b0;
+end
+endtask
+
+task wr_burst;
+  input [31:0] addr;
+  input [31:0] len;
+  input [31:0] seed;
+  integer      wbeat;
+begin
+  for (wbeat = 0; wbeat < len; wbeat = wbeat + 1)
+  begin
+    wr_single(addr + wbeat*4, pattern(addr + wbeat*4, seed));
+  end
+end
+endtask
+
+task rd_cmd;
+  input [31:0] addr;
+  input [31:0] len;
+begin
+  while (arready == 1'b0)
+  begin
+    @(negedge clk);
+  end
+
+  araddr                      <= addr;
+  arlen                       <= len - 1;
+  arvalid                     <= 1'b1;
+  @(negedge clk);
+  arvalid                     <= 1'b0;
+end
+endtask
+
+task rd_single;
+  input  [31:0] addr;
+  output [31:0] data;
+begin
+  rd_cmd(addr, 1);
+
+  @(negedge clk);
+  while (rvalid !== 1'b1)
+  begin
+    @(negedge clk);
+  end
+
+  data                         = rdata;
+end
+endtask
+
+task rd_burst;
+  input [31:0] addr;
+  input [31:0] len;
+  input [31:0] seed;
+begin
+  rd_cmd(addr, len);
+
+  beat                         = 0;
+  while (beat < len)
+  begin
+    @(negedge clk);
+    if (rvalid === 1'b1)
+    begin
+      check(addr + beat*4, rdata, pattern(addr + beat*4, seed));
+      beat                     = beat + 1;
+    end
+  end
+end
+endtask
+
+// -----------------------------------------------
+// Traffic sequence
+// -----------------------------------------------
+
+`include "bench_seq.vh"
+
+// -----------------------------------------------
+// AXI memory model
+// -----------------------------------------------
+
+  mem_model_axi mem
+  (
+    .clk                    (clk),
+    .nreset                 (rst_n),
+
+    .awaddr                 (awaddr),
+    .awvalid                (awvalid),
+    .awready                (awready),
+    .awlen                  (awlen),
+    .awburst                (2'b01),
+    .awsize                 (3'b010),
+    .awid                   (4'h0),
+
+    .wdata                  (wdata),
+    .wvalid                 (wvalid),
+    .wready                 (wready),
+    .wstrb                  (4'hf),
+
+    .bvalid                 (bvalid),
+    .bready                 (1'b1),
+    .bid                    (),
+
+    .araddr                 (araddr),
+    .arvalid                (arvalid),
+    .arready                (arready),
+    .arlen                  (arlen),
+    .arburst                (2'b01),
+    .arsize                 (3'b010),
+    .arid                   (4'h0),
+
+    .rdata                  (rdata),
+    .rvalid                 (rvalid),
+    .rready                 (1'b1),
+    .rlast                  (rlast),
+    .rid                    ()
+  );
+
+endmodule
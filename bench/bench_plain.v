@@ -0,0 +1,218 @@
+// -----------------------------------------------------------------------------
+//  Title      : Benchmark driver for the plain memory model
+//  Project    : UNKNOWN
+// -----------------------------------------------------------------------------
+//  File       : bench_plain.v
+//  Author     : Simon Southwell
+//  Created    : 2026-10-18
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  Drives the benchmark traffic through the mem_model module directly,
+//  with single transfers on the register style port and bursts on the
+//  burst write (tx) and burst read (rx) ports. Inputs are driven on the
+//  falling edge of clk, as the model samples writes on the falling edge
+//  and reads on the rising edge.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2026 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation(), either version 3 of the License(), or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful(),
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+module bench_plain
+#(parameter WORDS            = 65536,
+  parameter BURST_LEN        = 16)
+(
+  input                        clk,
+  input                        rst_n
+);
+
+localparam                     NAME = "plain";
+
+reg  [31:0]                    address;
+reg                            write;
+reg  [31:0]                    writedata;
+reg                            read;
+wire [31:0]                    readdata;
+wire                           readdatavalid;
+
+wire                           rx_waitrequest;
+reg  [11:0]                    rx_burstcount;
+reg  [31:0]                    rx_address;
+reg                            rx_read;
+wire [31:0]                    rx_readdata;
+wire                           rx_readdatavalid;
+
+wire                           tx_waitrequest;
+reg  [11:0]                    tx_burstcount;
+reg  [31:0]                    tx_address;
+reg                            tx_write;
+reg  [31:0]                    tx_writedata;
+
+integer                        beat;
+
+initial
+begin
+  address                      = 32'h00000000;
+  write                        = 1'b0;
+  writedata                    = 32'h00000000;
+  read                         = 1'b0;
+  rx_burstcount                = 12'h000;
+  rx_address                   = 32'h00000000;
+  rx_read                      = 1'b0;
+  tx_burstcount                = 12'h000;
+  tx_address                   = 32'h00000000;
+  tx_write                     = 1'b0;
+  tx_writedata                 = 32'h00000000;
+end
+
+// -----------------------------------------------
+// Wrapper transfer tasks
+// -----------------------------------------------
+
+task bench_align;
+begin
+  @(negedge clk);
+end
+endtask
+
+task bench_idle;
+begin
+  repeat (2) @(negedge clk);
+end
+endtask
+
+task wr_single;
+  input [31:0] addr;
+  input [31:0] data;
+begin
+  address                     <= addr;
+  writedata                   <= data;
+  write                       <= 1'b1;
+  @(negedge clk);
+  write                       <= 1'b0;
+end
+endtask
+
+// Read data is returned on the rising edge after read is driven
+task rd_single;
+  input  [31:0] addr;
+  output [31:0] data;
+begin
+  address                     <= addr;
+  read                        <= 1'b1;
+  @(negedge clk);
+  read                        <= 1'b0;
+  data                         = readdata;
+end
+endtask
+
+// A write burst is never stalled, as a read burst is always complete before one starts
+task wr_burst;
+  input [31:0] addr;
+  input [31:0] len;
+  input [31:0] seed;
+begin
+  tx_address                  <= addr;
+  tx_burstcount               <= len;
+  tx_write                    <= 1'b1;
+
+  for (beat = 0; beat < len; beat = beat + 1)
+  begin
+    tx_writedata              <= pattern(addr + beat*4, seed);
+    @(negedge clk);
+  end
+
+  tx_write                    <= 1'b0;
+end
+endtask
+
+task rd_burst;
+  input [31:0] addr;
+  input [31:0] len;
+  input [31:0] seed;
+begin
+  rx_address                  <= addr;
+  rx_burstcount               <= len;
+  rx_read                     <= 1'b1;
+
+  // The command is accepted on the first falling edge without a wait request
+  @(negedge clk);
+  while (rx_waitrequest == 1'b1)
+  begin
+    @(negedge clk);
+  end
+
+  rx_read                     <= 1'b0;
+
+  beat                         = 0;
+  while (beat < len)
+  begin
+    @(negedge clk);
+    if (rx_readdatavalid == 1'b1)
+    begin
+      check(addr + beat*4, rx_readdata, pattern(addr + beat*4, seed));
+      beat                     = beat + 1;
+    end
+  end
+end
+endtask
+
+// -----------------------------------------------
+// Traffic sequence
+// -----------------------------------------------
+
+`include "bench_seq.vh"
+
+// -----------------------------------------------
+// Memory model
+// -----------------------------------------------
+
+  mem_model #(.EN_READ_QUEUE(0), .REG_READ_OVERLAP(1)) mem
+  (
+    .clk                    (clk),
+    .rst_n                  (rst_n),
+
+    .address                (address),
+    .write                  (write),
+    .writedata              (writedata),
+    .byteenable             (4'hf),
+    .read                   (read),
+    .readdata               (readdata),
+    .readdatavalid          (readdatavalid),
+
+    .rx_waitrequest         (rx_waitrequest),
+    .rx_burstcount          (rx_burstcount),
+    .rx_address             (rx_address),
+    .rx_read                (rx_read),
+    .rx_readdata            (rx_readdata),
+    .rx_readdatavalid       (rx_readdatavalid),
+
+    .tx_waitrequest         (tx_waitrequest),
+    .tx_burstcount          (tx_burstcount),
+    .tx_address             (tx_address),
+    .tx_write               (tx_write),
+    .tx_writedata           (tx_writedata),
+`ifdef MEM_EN_TX_BYTEENABLE
+    .tx_byteenable          (4'hf),
+`endif
+
+    .wr_port_valid          (1'b0),
+    .wr_port_data           (32'h00000000),
+    .wr_port_addr           (32'h00000000)
+  );
+
+endmodule
@@ -0,0 +1,222 @@
+// -----------------------------------------------------------------------------
+//  Title      : Benchmark traffic sequence for memory model wrappers
+//  Project    : UNKNOWN
+// -----------------------------------------------------------------------------
+//  File       : bench_seq.vh
+//  Author     : Simon Southwell
+//  Created    : 2026-10-18
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  Traffic sequence and reporting common to all the benchmark drivers,
+//  included in the body of each driver module. The including module must
+//  have clk and rst_n ports, WORDS and BURST_LEN parameters, a NAME
+//  localparam, and define the following tasks for its wrapper:
+//
+//    bench_align                 Align to the driver's clock edge after reset
+//    wr_single (addr, data)      Single word write
+//    rd_single (addr, data)      Single word read
+//    wr_burst  (addr, len, seed) Burst write of pattern(addr, seed) words
+//    rd_burst  (addr, len, seed) Burst read, checking against pattern()
+//    bench_idle                  Wait for any outstanding transfers
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2026 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation(), either version 3 of the License(), or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful(),
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+`ifndef MEMHOSTTIME
+`ifdef MEM_MODEL_SV
+`define MEMHOSTTIME           MemHostTime
+`else
+`define MEMHOSTTIME           $memhosttime
+`endif
+`endif
+
+// Separate regions for each phase, so stale data from one can't pass in another
+localparam                     SINGLE_BASE = 32'h00000000;
+localparam                     BURST_BASE  = 32'h01000000;
+localparam                     MIXED_BASE  = 32'h02000000;
+
+// Most data errors reported individually
+localparam                     MAX_ERR_MSGS = 10;
+
+integer                        errors;
+integer                        beats;
+integer                        cycles;
+integer                        phase_cycle;
+integer                        phase_us;
+integer                        total_beats;
+integer                        total_us;
+integer                        host_us;
+integer                        idx;
+reg  [31:0]                    rdata_s;
+reg  [31:0]                    addr_s;
+
+initial
+begin
+  errors                       = 0;
+  cycles                       = 0;
+  total_beats                  = 0;
+  total_us                     = 0;
+end
+
+always @(posedge clk)
+begin
+  cycles                      <= cycles + 1;
+end
+
+// -----------------------------------------------
+// Test data pattern for a word address
+// -----------------------------------------------
+
+function [31:0] pattern;
+  input [31:0] addr;
+  input [31:0] seed;
+begin
+  pattern                      = (addr * 32'h9e3779b1) ^ seed;
+end
+endfunction
+
+// -----------------------------------------------
+// Check read data against that expected
+// -----------------------------------------------
+
+task check;
+  input [31:0] addr;
+  input [31:0] data;
+  input [31:0] exp;
+begin
+  if (data !== exp)
+  begin
+    errors                     = errors + 1;
+
+    if (errors <= MAX_ERR_MSGS)
+    begin
+      $display("***Error --- %0s: read 0x%08h from address 0x%08h, expected 0x%08h", NAME, data, addr, exp);
+    end
+  end
+end
+endtask
+
+// -----------------------------------------------
+// Phase timing and reporting
+// -----------------------------------------------
+
+task phase_start;
+begin
+  beats                        = 0;
+  phase_cycle                  = cycles;
+  `MEMHOSTTIME(phase_us);
+end
+endtask
+
+task phase_end;
+  input [8*8-1:0] phase;
+begin
+  `MEMHOSTTIME(host_us);
+  host_us                      = host_us - phase_us;
+
+  total_beats                  = total_beats + beats;
+  total_us                     = total_us    + host_us;
+
+  $display("%0s %0s: %0d beats in %0d cycles, %0d us: %0.0f beats/s, %0.3f us/access",
+           NAME, phase, beats, cycles - phase_cycle, host_us,
+           (host_us > 0) ? beats * 1.0e6 / host_us : 0.0,
+           (beats   > 0) ? host_us * 1.0   / beats  : 0.0);
+end
+endtask
+
+// -----------------------------------------------
+// Traffic sequence
+// -----------------------------------------------
+
+initial
+begin
+  // Start timing from a first call, so that the phases aren't skewed by it
+  `MEMHOSTTIME(host_us);
+
+  wait (rst_n === 1'b1);
+  bench_align;
+
+  // Single transfers: write a region word by word, then read it back
+  phase_start;
+
+  for (idx = 0; idx < WORDS; idx = idx + 1)
+  begin
+    addr_s                     = SINGLE_BASE + idx*4;
+    wr_single(addr_s, pattern(addr_s, 32'h00000001));
+  end
+
+  for (idx = 0; idx < WORDS; idx = idx + 1)
+  begin
+    addr_s                     = SINGLE_BASE + idx*4;
+    rd_single(addr_s, rdata_s);
+    check(addr_s, rdata_s, pattern(addr_s, 32'h00000001));
+  end
+
+  beats                        = 2*WORDS;
+  bench_idle;
+  phase_end("single");
+
+  // Bursts: write a region in bursts, then read it back in bursts
+  phase_start;
+
+  for (idx = 0; idx < WORDS/BURST_LEN; idx = idx + 1)
+  begin
+    wr_burst(BURST_BASE + idx*BURST_LEN*4, BURST_LEN, 32'h00000002);
+  end
+
+  for (idx = 0; idx < WORDS/BURST_LEN; idx = idx + 1)
+  begin
+    rd_burst(BURST_BASE + idx*BURST_LEN*4, BURST_LEN, 32'h00000002);
+  end
+
+  beats                        = 2*(WORDS/BURST_LEN)*BURST_LEN;
+  bench_idle;
+  phase_end("burst");
+
+  // Mixed: a burst write and a single write, each read straight back
+  phase_start;
+
+  for (idx = 0; idx < WORDS/(BURST_LEN+1); idx = idx + 1)
+  begin
+    addr_s                     = MIXED_BASE + idx*(BURST_LEN+1)*4;
+    wr_burst(addr_s, BURST_LEN, 32'h00000003);
+    wr_single(addr_s + BURST_LEN*4, pattern(addr_s + BURST_LEN*4, 32'h00000003));
+    rd_burst(addr_s, BURST_LEN, 32'h00000003);
+    rd_single(addr_s + BURST_LEN*4, rdata_s);
+    check(addr_s + BURST_LEN*4, rdata_s, pattern(addr_s + BURST_LEN*4, 32'h00000003));
+  end
+
+  beats                        = 2*(WORDS/(BURST_LEN+1))*(BURST_LEN+1);
+  bench_idle;
+  phase_end("mixed");
+
+  $display("%0s total: %0d beats, %0d us: %0.0f beats/s",
+           NAME, total_beats, total_us, (total_us > 0) ? total_beats * 1.0e6 / total_us : 0.0);
+
+  // Fail with a non-zero simulator exit status, so that make sees the failure
+  if (errors == 0)
+  begin
+    $display("%0s: PASS", NAME);
+    $finish;
+  end
+  else
+  begin
+    $fatal(1, "%0s: FAIL (%0d errors)", NAME, errors);
+  end
+end
@@ -0,0 +1,107 @@
+// -----------------------------------------------------------------------------
+//  Title      : Throughput benchmark test bench for memory model
+//  Project    : UNKNOWN
+// -----------------------------------------------------------------------------
+//  File       : tb_bench.v
+//  Author     : Simon Southwell
+//  Created    : 2026-10-18
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  Top level of a self-checking benchmark for the memory model's HDL
+//  wrappers, not requiring VProc. The WRAPPER parameter selects a driver
+//  for the plain (0), AXI (1), AHB (2) or APB (3) wrapper, which runs
+//  sustained single, burst and mixed traffic through it, checks all the
+//  data read back, and reports the throughput of each phase in beats per
+//  host second and host time per access.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2026 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation(), either version 3 of the License(), or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful(),
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+`timescale 1ps/1ps
+
+`define RESET_PERIOD    10
+
+module tb_bench
+#(parameter WRAPPER          = 0,       // 0 = plain, 1 = AXI, 2 = AHB, 3 = APB
+  parameter WORDS            = 65536,   // Words written, and read back, in each phase
+  parameter BURST_LEN        = 16,      // Transfers per burst (4, 8 or 16 for AHB defined length bursts)
+  parameter CLK_FREQ_MHZ     = 100,
+  parameter TIMEOUT_COUNT    = 64*WORDS)
+();
+
+// Clock, reset and simulation control state
+reg            clk;
+wire           reset_n;
+integer        count;
+
+// -----------------------------------------------
+// Initialisation, clock and reset
+// -----------------------------------------------
+
+initial
+begin
+   count                               = -1;
+   clk                                 = 1'b1;
+end
+
+// Generate a clock
+always #(500000/CLK_FREQ_MHZ) clk      = ~clk;
+
+// Generate a reset signal using count
+assign reset_n                         = (count >= `RESET_PERIOD) ? 1'b1 : 1'b0;
+
+// -----------------------------------------------
+// Simulation control process
+// -----------------------------------------------
+
+// The drivers finish the simulation when complete, so only a timeout stops it here
+always @(posedge clk)
+begin
+  count                                <= count + 1;
+
+  if (count == TIMEOUT_COUNT)
+  begin
+    $fatal(1, "***Error --- tb_bench: timed out after %0d cycles", count);
+  end
+end
+
+// -----------------------------------------------
+// Wrapper driver
+// -----------------------------------------------
+
+generate
+if (WRAPPER == 1)
+begin : g_axi
+  bench_axi   #(.WORDS(WORDS), .BURST_LEN(BURST_LEN)) drv (.clk(clk), .rst_n(reset_n));
+end
+else if (WRAPPER == 2)
+begin : g_ahb
+  bench_ahb   #(.WORDS(WORDS), .BURST_LEN(BURST_LEN)) drv (.clk(clk), .rst_n(reset_n));
+end
+else if (WRAPPER == 3)
+begin : g_apb
+  bench_apb   #(.WORDS(WORDS), .BURST_LEN(BURST_LEN)) drv (.clk(clk), .rst_n(reset_n));
+end
+else
+begin : g_plain
+  bench_plain #(.WORDS(WORDS), .BURST_LEN(BURST_LEN)) drv (.clk(clk), .rst_n(reset_n));
+end
+endgenerate
+
+endmodule
@@ -0,0 +1,685 @@
+-- -----------------------------------------------------------------------------
+--  Title      : Throughput benchmark test bench for memory model
+--  Project    : UNKNOWN
+-- -----------------------------------------------------------------------------
+--  File       : tb_bench.vhd
+--  Author     : Simon Southwell
+--  Created    : 2026-10-18
+--  Standard   : VHDL 2008
+-- -----------------------------------------------------------------------------
+--  Description:
+--  VHDL equivalent of tb_bench.v. A self-checking benchmark for the memory
+--  model's VHDL wrappers, not requiring VProc. The WRAPPER generic selects
+--  the plain (0), AXI (1), AHB (2) or APB (3) wrapper, and sustained single,
+--  burst and mixed traffic is run through it, with all the data read back
+--  checked, and the throughput of each phase reported in beats per host
+--  second and host time per access.
+--
+--  The VHDL AHB wrapper only takes SINGLE and undefined length INCR bursts,
+--  samples write data in the middle of the data phase and needs an idle
+--  cycle after each transfer or burst, and so is driven accordingly.
+-- -----------------------------------------------------------------------------
+--  Copyright (c) 2026 Simon Southwell
+-- -----------------------------------------------------------------------------
+--
+--  This is free software: you can redistribute it and/or modify
+--  it under the terms of the GNU General Public License as published by
+--  the Free Software Foundation(), either version 3 of the License(), or
+--  (at your option) any later version.
+--
+--  It is distributed in the hope that it will be useful(),
+--  but WITHOUT ANY WARRANTY; without even the implied warranty of
+--  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+--  GNU General Public License for more details.
+--
+--  You should have received a copy of the GNU General Public License
+--  along with this code. If not, see <http://www.gnu.org/licenses/>.
+--
+-- -----------------------------------------------------------------------------
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+library std;
+use std.textio.all;
+
+use work.mem_model_pkg.all;
+
+entity tb_bench is
+  generic (
+    WRAPPER               : integer := 0;       -- 0 = plain, 1 = AXI, 2 = AHB, 3 = APB
+    WORDS                 : integer := 65536;   -- Words written, and read back, in each phase
+    BURST_LEN             : integer := 16;      -- Transfers per burst
+    CLK_FREQ_MHZ          : integer := 100;
+    TIMEOUT_COUNT         : integer := 64*WORDS
+  );
+end entity;
+
+architecture bench of tb_bench is
+
+constant RESET_PERIOD         : integer := 10;
+
+-- Separate regions for each phase, so stale data from one can't pass in another
+constant SINGLE_BASE          : integer := 16#00000000#;
+constant BURST_BASE           : integer := 16#01000000#;
+constant MIXED_BASE           : integer := 16#02000000#;
+
+-- Most data errors reported individually
+constant MAX_ERR_MSGS         : integer := 10;
+
+constant TRANS_IDLE           : std_logic_vector (1 downto 0) := "00";
+constant TRANS_NONSEQ         : std_logic_vector (1 downto 0) := "10";
+constant TRANS_SEQ            : std_logic_vector (1 downto 0) := "11";
+
+constant BURST_SINGLE         : std_logic_vector (2 downto 0) := "000";
+constant BURST_INCR           : std_logic_vector (2 downto 0) := "001";
+
+-- Clock, reset and simulation control state
+signal clk                    : std_logic := '1';
+signal reset_n                : std_logic;
+signal count                  : integer   := -1;
+
+-- Plain memory model signals
+signal address                : std_logic_vector (31 downto 0) := (others => '0');
+signal av_write               : std_logic := '0';
+signal writedata              : std_logic_vector (31 downto 0) := (others => '0');
+signal av_read                : std_logic := '0';
+signal readdata               : std_logic_vector (31 downto 0);
+signal readdatavalid          : std_logic;
+
+signal rx_waitrequest         : std_logic;
+signal rx_burstcount          : std_logic_vector (11 downto 0) := (others => '0');
+signal rx_address             : std_logic_vector (31 downto 0) := (others => '0');
+signal rx_read                : std_logic := '0';
+signal rx_readdata            : std_logic_vector (31 downto 0);
+signal rx_readdatavalid       : std_logic;
+
+signal tx_waitrequest         : std_logic;
+signal tx_burstcount          : std_logic_vector (11 downto 0) := (others => '0');
+signal tx_address             : std_logic_vector (31 downto 0) := (others => '0');
+signal tx_write               : std_logic := '0';
+signal tx_writedata           : std_logic_vector (31 downto 0) := (others => '0');
+
+-- AXI signals
+signal awaddr                 : std_logic_vector (31 downto 0) := (others => '0');
+signal awvalid                : std_logic := '0';
+signal awready                : std_logic;
+signal awlen                  : std_logic_vector ( 7 downto 0) := (others => '0');
+signal wdata                  : std_logic_vector (31 downto 0) := (others => '0');
+signal wvalid                 : std_logic := '0';
+signal wready                 : std_logic;
+signal bvalid                 : std_logic;
+signal araddr                 : std_logic_vector (31 downto 0) := (others => '0');
+signal arvalid                : std_logic := '0';
+signal arready                : std_logic;
+signal arlen                  : std_logic_vector ( 7 downto 0) := (others => '0');
+signal rdata                  : std_logic_vector (31 downto 0);
+signal rvalid                 : std_logic;
+signal rlast                  : std_logic;
+
+-- AHB signals
+signal hsel                   : std_logic := '0';
+signal haddr                  : std_logic_vector (31 downto 0) := (others => '0');
+signal hwdata                 : std_logic_vector (31 downto 0) := (others => '0');
+signal hwrite                 : std_logic := '0';
+signal hburst                 : std_logic_vector ( 2 downto 0) := BURST_SINGLE;
+signal htrans                 : std_logic_vector ( 1 downto 0) := TRANS_IDLE;
+signal hrdata                 : std_logic_vector (31 downto 0);
+signal hready                 : std_logic;
+signal hresp                  : std_logic;
+
+-- APB signals
+signal psel                   : std_logic := '0';
+signal paddr                  : std_logic_vector (31 downto 0) := (others => '0');
+signal pwdata                 : std_logic_vector (31 downto 0) := (others => '0');
+signal pwrite                 : std_logic := '0';
+signal penable                : std_logic := '0';
+signal prdata                 : std_logic_vector (31 downto 0);
+signal pready                 : std_logic;
+signal pslverr                : std_logic;
+
+-- -----------------------------------------------
+-- Name of the selected wrapper
+-- -----------------------------------------------
+
+function wrapper_name return string is
+begin
+  case WRAPPER is
+  when 1      => return "axi";
+  when 2      => return "ahb";
+  when 3      => return "apb";
+  when others => return "plain";
+  end case;
+end function;
+
+constant NAME                 : string := wrapper_name;
+
+-- -----------------------------------------------
+-- Test data pattern for a word address
+-- -----------------------------------------------
+
+function pattern (addr : integer; seed : integer) return std_logic_vector is
+  variable prod : unsigned (63 downto 0);
+begin
+  prod := to_unsigned(addr, 32) * unsigned'(x"9e3779b1");
+  return std_logic_vector(prod(31 downto 0) xor to_unsigned(seed, 32));
+end function;
+
+function to_slv (addr : integer) return std_logic_vector is
+begin
+  return std_logic_vector(to_unsigned(addr, 32));
+end function;
+
+begin
+
+-- -----------------------------------------------
+-- Clock and reset
+-- -----------------------------------------------
+
+  clk                         <= not clk after 500000 ps / CLK_FREQ_MHZ;
+
+  reset_n                     <= '1' when count >= RESET_PERIOD else '0';
+
+-- -----------------------------------------------
+-- Simulation control process
+-- -----------------------------------------------
+
+-- The stimulus process finishes the simulation when complete, so only a timeout stops it here
+process (clk)
+begin
+  if rising_edge(clk) then
+    count                     <= count + 1;
+
+    if count = TIMEOUT_COUNT then
+      report "***Error --- tb_bench: timed out after " & integer'image(count) & " cycles";
+      std.env.finish(1);
+    end if;
+  end if;
+end process;
+
+-- -----------------------------------------------
+-- Stimulus process
+-- -----------------------------------------------
+
+process
+  variable errors             : integer := 0;
+  variable beats              : integer := 0;
+  variable phase_cycle        : integer := 0;
+  variable phase_us           : integer := 0;
+  variable total_beats        : integer := 0;
+  variable total_us           : integer := 0;
+  variable host_us            : integer := 0;
+  variable addr_v             : integer;
+  variable rdata_v            : std_logic_vector (31 downto 0);
+
+  -- Check read data against that expected
+  procedure check (addr : integer; data : std_logic_vector; exp : std_logic_vector) is
+    variable l : line;
+  begin
+    if data /= exp then
+      errors                  := errors + 1;
+
+      if errors <= MAX_ERR_MSGS then
+        write(l, "***Error --- " & NAME & ": read 0x" & to_hstring(data) & " from address 0x" &
+                 to_hstring(to_slv(addr)) & ", expected 0x" & to_hstring(exp));
+        writeline(output, l);
+      end if;
+    end if;
+  end procedure;
+
+  -- Phase timing and reporting
+  procedure phase_start is
+  begin
+    beats                     := 0;
+    phase_cycle               := count;
+    MemHostTime(phase_us);
+  end procedure;
+
+  procedure phase_end (phase : string) is
+    variable l    : line;
+    variable rate : real := 0.0;
+    variable per  : real := 0.0;
+  begin
+    MemHostTime(host_us);
+    host_us                   := host_us - phase_us;
+
+    total_beats               := total_beats + beats;
+    total_us                  := total_us    + host_us;
+
+    if host_us > 0 then
+      rate                    := real(beats) * 1.0e6 / real(host_us);
+    end if;
+
+    if beats > 0 then
+      per                     := real(host_us) / real(beats);
+    end if;
+
+    write(l, NAME & " " & phase & ": " & integer'image(beats) & " beats in " &
+             integer'image(count - phase_cycle) & " cycles, " & integer'image(host_us) & " us: " &
+             to_string(rate, 1) & " beats/s, " & to_string(per, 3) & " us/access");
+    writeline(output, l);
+  end procedure;
+
+  -- -----------------------------------------------
+  -- Wrapper transfer procedures
+  -- -----------------------------------------------
+
+  -- APB is driven on the rising edge of clk, all the others on the falling edge
+  procedure bench_align is
+  begin
+    if WRAPPER = 3 then
+      wait until rising_edge(clk);
+    else
+      wait until falling_edge(clk);
+    end if;
+  end procedure;
+
+  procedure bench_idle is
+  begin
+    for i in 1 to 4 loop
+      bench_align;
+    end loop;
+  end procedure;
+
+  -- An APB setup phase followed by an access phase, extended until pready
+  procedure apb_xfer (addr : integer; wnr : std_logic; wd : std_logic_vector; rd : out std_logic_vector) is
+  begin
+    psel                      <= '1';
+    penable                   <= '0';
+    paddr                     <= to_slv(addr);
+    pwrite                    <= wnr;
+    pwdata                    <= wd;
+    wait until rising_edge(clk);
+
+    penable                   <= '1';
+    wait until falling_edge(clk);
+    while pready /= '1' loop
+      wait until falling_edge(clk);
+    end loop;
+
+    rd                        := prdata;
+    wait until rising_edge(clk);
+
+    psel                      <= '0';
+    penable                   <= '0';
+  end procedure;
+
+  -- An AXI read command, with valid only raised for a single cycle when there's room
+  procedure axi_rd_cmd (addr : integer; len : integer) is
+  begin
+    while arready /= '1' loop
+      wait until falling_edge(clk);
+    end loop;
+
+    araddr                    <= to_slv(addr);
+    arlen                     <= std_logic_vector(to_unsigned(len - 1, 8));
+    arvalid                   <= '1';
+    wait until falling_edge(clk);
+    arvalid                   <= '0';
+  end procedure;
+
+  procedure wr_single (addr : integer; data : std_logic_vector) is
+  begin
+    case WRAPPER is
+    when 1 =>
+      while awready /= '1' or wready /= '1' loop
+        wait until falling_edge(clk);
+      end loop;
+
+      awaddr                  <= to_slv(addr);
+      awlen                   <= x"00";
+      awvalid                 <= '1';
+      wdata                   <= data;
+      wvalid                  <= '1';
+      wait until falling_edge(clk);
+      awvalid                 <= '0';
+      wvalid                  <= '0';
+
+    when 2 =>
+      hsel                    <= '1';
+      haddr                   <= to_slv(addr);
+      hwrite                  <= '1';
+      hburst                  <= BURST_SINGLE;
+      htrans                  <= TRANS_NONSEQ;
+      hwdata                  <= data;
+      wait until falling_edge(clk);
+      htrans                  <= TRANS_IDLE;
+      wait until falling_edge(clk);
+
+    when 3 =>
+      apb_xfer(addr, '1', data, rdata_v);
+
+    when others =>
+      address                 <= to_slv(addr);
+      writedata               <= data;
+      av_write                <= '1';
+      wait until falling_edge(clk);
+      av_write                <= '0';
+    end case;
+  end procedure;
+
+  procedure rd_single (addr : integer; data : out std_logic_vector) is
+  begin
+    case WRAPPER is
+    when 1 =>
+      axi_rd_cmd(addr, 1);
+
+      wait until falling_edge(clk);
+      while rvalid /= '1' loop
+        wait until falling_edge(clk);
+      end loop;
+
+      data                    := rdata;
+
+    when 2 =>
+      hsel                    <= '1';
+      haddr                   <= to_slv(addr);
+      hwrite                  <= '0';
+      hburst                  <= BURST_SINGLE;
+      htrans                  <= TRANS_NONSEQ;
+      wait until falling_edge(clk);
+      data                    := hrdata;
+      htrans                  <= TRANS_IDLE;
+      wait until falling_edge(clk);
+
+    when 3 =>
+      apb_xfer(addr, '0', x"00000000", data);
+
+    when others =>
+      address                 <= to_slv(addr);
+      av_read                 <= '1';
+      wait until falling_edge(clk);
+      av_read                 <= '0';
+      data                    := readdata;
+    end case;
+  end procedure;
+
+  procedure wr_burst (addr : integer; len : integer; seed : integer) is
+  begin
+    case WRAPPER is
+    -- The AXI wrapper takes one write data beat per write address
+    when 1 | 3 =>
+      for beat in 0 to len-1 loop
+        wr_single(addr + beat*4, pattern(addr + beat*4, seed));
+      end loop;
+
+    -- Write data is driven with the address, as sampled in the middle of the data phase
+    when 2 =>
+      for beat in 0 to len-1 loop
+        hsel                  <= '1';
+        haddr                 <= to_slv(addr + beat*4);
+        hwrite                <= '1';
+        hburst                <= BURST_INCR;
+        htrans                <= TRANS_NONSEQ when beat = 0 else TRANS_SEQ;
+        hwdata                <= pattern(addr + beat*4, seed);
+        wait until falling_edge(clk);
+      end loop;
+
+      htrans                  <= TRANS_IDLE;
+      wait until falling_edge(clk);
+
+    -- A write burst is never stalled, as a read burst is always complete before one starts
+    when others =>
+      tx_address              <= to_slv(addr);
+      tx_burstcount           <= std_logic_vector(to_unsigned(len, 12));
+      tx_write                <= '1';
+
+      for beat in 0 to len-1 loop
+        tx_writedata          <= pattern(addr + beat*4, seed);
+        wait until falling_edge(clk);
+      end loop;
+
+      tx_write                <= '0';
+    end case;
+  end procedure;
+
+  procedure rd_burst (addr : integer; len : integer; seed : integer) is
+    variable beat : integer;
+  begin
+    case WRAPPER is
+    when 1 =>
+      axi_rd_cmd(addr, len);
+
+      beat                    := 0;
+      while beat < len loop
+        wait until falling_edge(clk);
+        if rvalid = '1' then
+          check(addr + beat*4, rdata, pattern(addr + beat*4, seed));
+          beat                := beat + 1;
+        end if;
+      end loop;
+
+    when 2 =>
+      for b in 0 to len-1 loop
+        hsel                  <= '1';
+        haddr                 <= to_slv(addr + b*4);
+        hwrite                <= '0';
+        hburst                <= BURST_INCR;
+        htrans                <= TRANS_NONSEQ when b = 0 else TRANS_SEQ;
+        wait until falling_edge(clk);
+        check(addr + b*4, hrdata, pattern(addr + b*4, seed));
+      end loop;
+
+      htrans                  <= TRANS_IDLE;
+      wait until falling_edge(clk);
+
+    when 3 =>
+      for b in 0 to len-1 loop
+        apb_xfer(addr + b*4, '0', x"00000000", rdata_v);
+        check(addr + b*4, rdata_v, pattern(addr + b*4, seed));
+      end loop;
+
+    -- The command is accepted on the first falling edge without a wait request
+    when others =>
+      rx_address              <= to_slv(addr);
+      rx_burstcount           <= std_logic_vector(to_unsigned(len, 12));
+      rx_read                 <= '1';
+
+      wait until falling_edge(clk);
+      while rx_waitrequest = '1' loop
+        wait until falling_edge(clk);
+      end loop;
+
+      rx_read                 <= '0';
+
+      beat                    := 0;
+      while beat < len loop
+        wait until falling_edge(clk);
+        if rx_readdatavalid = '1' then
+          check(addr + beat*4, rx_readdata, pattern(addr + beat*4, seed));
+          beat                := beat + 1;
+        end if;
+      end loop;
+    end case;
+  end procedure;
+
+  variable l                  : line;
+
+begin
+
+  -- Start timing from a first call, so that the phases aren't skewed by it
+  MemHostTime(host_us);
+
+  wait until reset_n = '1';
+  bench_align;
+
+  -- Single transfers: write a region word by word, then read it back
+  phase_start;
+
+  for i in 0 to WORDS-1 loop
+    addr_v                    := SINGLE_BASE + i*4;
+    wr_single(addr_v, pattern(addr_v, 1));
+  end loop;
+
+  for i in 0 to WORDS-1 loop
+    addr_v                    := SINGLE_BASE + i*4;
+    rd_single(addr_v, rdata_v);
+    check(addr_v, rdata_v, pattern(addr_v, 1));
+  end loop;
+
+  beats                       := 2*WORDS;
+  bench_idle;
+  phase_end("single");
+
+  -- Bursts: write a region in bursts, then read it back in bursts
+  phase_start;
+
+  for i in 0 to WORDS/BURST_LEN-1 loop
+    wr_burst(BURST_BASE + i*BURST_LEN*4, BURST_LEN, 2);
+  end loop;
+
+  for i in 0 to WORDS/BURST_LEN-1 loop
+    rd_burst(BURST_BASE + i*BURST_LEN*4, BURST_LEN, 2);
+  end loop;
+
+  beats                       := 2*(WORDS/BURST_LEN)*BURST_LEN;
+  bench_idle;
+  phase_end("burst");
+
+  -- Mixed: a burst write and a single write, each read straight back
+  phase_start;
+
+  for i in 0 to WORDS/(BURST_LEN+1)-1 loop
+    addr_v                    := MIXED_BASE + i*(BURST_LEN+1)*4;
+    wr_burst(addr_v, BURST_LEN, 3);
+    wr_single(addr_v + BURST_LEN*4, pattern(addr_v + BURST_LEN*4, 3));
+    rd_burst(addr_v, BURST_LEN, 3);
+    rd_single(addr_v + BURST_LEN*4, rdata_v);
+    check(addr_v + BURST_LEN*4, rdata_v, pattern(addr_v + BURST_LEN*4, 3));
+  end loop;
+
+  beats                       := 2*(WORDS/(BURST_LEN+1))*(BURST_LEN+1);
+  bench_idle;
+  phase_end("mixed");
+
+  write(l, NAME & " total: " & integer'image(total_beats) & " beats, " & integer'image(total_us) & " us: " &
+           to_string(real(total_beats) * 1.0e6 / real(maximum(total_us, 1)), 1) & " beats/s");
+  writeline(output, l);
+
+  -- Fail with a non-zero simulator exit status, so that make sees the failure
+  if errors = 0 then
+    write(l, NAME & ": PASS");
+    writeline(output, l);
+    std.env.finish;
+  else
+    write(l, NAME & ": FAIL (" & integer'image(errors) & " errors)");
+    writeline(output, l);
+    std.env.finish(1);
+  end if;
+end process;
+
+-- -----------------------------------------------
+-- Memory model wrapper
+-- -----------------------------------------------
+
+GEN_AXI : if WRAPPER = 1 generate
+
+  mem : entity work.mem_model_axi
+  port map (
+    clk                       => clk,
+    nreset                    => reset_n,
+
+    awaddr                    => awaddr,
+    awvalid                   => awvalid,
+    awready                   => awready,
+    awlen                     => awlen,
+
+    wdata                     => wdata,
+    wvalid                    => wvalid,
+    wready                    => wready,
+    wstrb                     => x"f",
+
+    bvalid                    => bvalid,
+    bready                    => '1',
+
+    araddr                    => araddr,
+    arvalid                   => arvalid,
+    arready                   => arready,
+    arlen                     => arlen,
+
+    rdata                     => rdata,
+    rvalid                    => rvalid,
+    rready                    => '1',
+    rlast                     => rlast
+  );
+
+elsif WRAPPER = 2 generate
+
+  mem : entity work.mem_model_ahb
+  port map (
+    hclk                      => clk,
+    hresetn                   => reset_n,
+
+    hsel                      => hsel,
+    haddr                     => haddr,
+    hwdata                    => hwdata,
+    hwrite                    => hwrite,
+    hburst                    => hburst,
+    hsize                     => "010",
+    htrans                    => htrans,
+    hmastlock                 => '0',
+    hwstrb                    => x"f",
+
+    hrdata                    => hrdata,
+    hready                    => hready,
+    hresp                     => hresp
+  );
+
+elsif WRAPPER = 3 generate
+
+  mem : entity work.mem_model_apb
+  port map (
+    pclk                      => clk,
+    presetn                   => reset_n,
+
+    psel                      => psel,
+    paddr                     => paddr,
+    pwdata                    => pwdata,
+    pwrite                    => pwrite,
+    penable                   => penable,
+    pstrb                     => x"f",
+    pprot                     => "000",
+
+    prdata                    => prdata,
+    pready                    => pready,
+    pslverr                   => pslverr
+  );
+
+else generate
+
+  mem : entity work.mem_model
+  generic map (
+    EN_READ_QUEUE             => false,
+    REG_READ_OVERLAP          => true
+  )
+  port map (
+    clk                       => clk,
+    rst_n                     => reset_n,
+
+    address                   => address,
+    byteenable                => x"f",
+    write                     => av_write,
+    writedata                 => writedata,
+    read                      => av_read,
+    readdata                  => readdata,
+    readdatavalid             => readdatavalid,
+
+    rx_waitrequest            => rx_waitrequest,
+    rx_burstcount             => rx_burstcount,
+    rx_address                => rx_address,
+    rx_read                   => rx_read,
+    rx_readdata               => rx_readdata,
+    rx_readdatavalid          => rx_readdatavalid,
+
+    tx_waitrequest            => tx_waitrequest,
+    tx_burstcount             => tx_burstcount,
+    tx_address                => tx_address,
+    tx_write                  => tx_write,
+    tx_byteenable             => x"f",
+    tx_writedata              => tx_writedata
+  );
+
+end generate;
+
+end bench;
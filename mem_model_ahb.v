@@ -4,9 +4,13 @@
 //
 // Copyright (c) 2024 Simon Southwell.
 //
-// Implements minimal compliant manager interface at 32-bits wide.
-// Also has a vectored irq input. Does not (yet) utilise VProc's burst
-// capabilities.
+// Implements an AHB subordinate interface at 32-bits wide, supporting
+// all burst types (SINGLE, INCR and INCR/WRAP 4, 8 and 16) and byte,
+// halfword and word transfer sizes, with zero wait state pipelined
+// data phases. Defined length bursts are passed to the C model as a
+// single burst operation, read at the start of the burst and written
+// at its end, whilst SINGLE and undefined length INCR transfers are
+// passed one transfer at a time.
 //
 // This file is part of VProc.
 //
@@ -25,6 +29,14 @@
 //
 // ====================================================================
 
+`ifdef MEM_MODEL_SV
+`define MEMREADBURST          MemReadBurst
+`define MEMWRITEBURST         MemWriteBurst
+`else
+`define MEMREADBURST          $memreadburst
+`define MEMWRITEBURST         $memwriteburst
+`endif
+
 `define AHB_SIZE_WORD         3'b010
 
 `define AHB_BURST_SINGLE      3'b000
@@ -35,6 +47,8 @@
 `define AHB_TRANS_NONSEQ      2'b10
 `define AHB_TRANS_SEQ         2'b11
 
+`define AHB_MAX_BURST         16
+
 module mem_model_ahb
 # (parameter
     ADDRWIDTH                 = 32, // For future proofing. Do not change.
@@ -61,35 +75,59 @@ module mem_model_ahb
 );
 
 wire                          active_access;
-wire                          mem_write;
-wire                          mem_read;
-wire                          mem_readdatavalid;
-wire [DATAWIDTH-1:0]          mem_readdata;
-wire [ADDRWIDTH-1:0]          mem_addr;
-wire [ADDRWIDTH-1:0]          mem_addr_rw;
-
-reg  [ADDRWIDTH-1:0]          mem_addr_phase;
-reg                           mem_write_phase;
+wire                          burst_defined;
+wire [4:0]                    burst_len;
+wire [4:0]                    burst_wrap;
+wire                          wr_continues;
+
+// Read burst state
+reg                           rd_phase;
+reg                           rd_burst;
+reg  [3:0]                    rd_idx;
+reg  [DATAWIDTH-1:0]          rd_data;
+
+// Write burst state
+reg                           wr_phase;
+reg  [ADDRWIDTH-1:0]          wr_addr;
+reg  [2:0]                    wr_size;
+reg  [4:0]                    wr_len;
+reg  [4:0]                    wr_wrap;
+reg  [4:0]                    wr_count;
 reg  [DATAWIDTH/8-1:0]        hwstrb_phase;
 
+// Burst data buffers passed to and from the C model
+`ifdef MEM_MODEL_SV
+int                           rd_buf  [0:`AHB_MAX_BURST-1];
+int                           wr_buf  [0:`AHB_MAX_BURST-1];
+int                           wr_be   [0:`AHB_MAX_BURST-1];
+`else
+reg  [31:0]                   rd_buf  [0:`AHB_MAX_BURST-1];
+reg  [31:0]                   wr_buf  [0:`AHB_MAX_BURST-1];
+reg  [31:0]                   wr_be   [0:`AHB_MAX_BURST-1];
+`endif
+
 // ---------------------------------------------------------
 // Combinatorial logic
 // ---------------------------------------------------------
 
-// Give error if selected, not idle, not a single or an undefined length incrementing burst, and not a 32 bit word transfer
-assign hresp                  = hsel & |htrans & (|hburst[2:1] | ((hsize != `AHB_SIZE_WORD) ? 1'b1 : 1'b0));
+// Give error if selected, not idle, and a transfer wider than the data bus
+assign hresp                  = hsel & |htrans & ((hsize > `AHB_SIZE_WORD) ? 1'b1 : 1'b0);
 
 // Access is active if selected, NONSEQ or SEQ and not an illegal transfer type
 assign active_access          =  hsel & htrans[1] & ~hresp;
-assign mem_write              =  hwrite & active_access;
-assign mem_read               = ~hwrite & active_access & ~(hburst == `AHB_BURST_SINGLE & mem_readdatavalid);
-assign mem_addr               = haddr;
-assign mem_addr_rw            =  mem_write_phase   ? mem_addr_phase : mem_addr;
 
-// The memory modelwon't stall on any access
+// INCR4/WRAP4, INCR8/WRAP8 and INCR16/WRAP16 are defined length bursts of 4, 8 and 16 transfers
+assign burst_defined          = |hburst[2:1];
+assign burst_len              = burst_defined ? (5'd4 << (hburst[2:1] - 2'd1)) : 5'd1;
+assign burst_wrap             = (burst_defined & ~hburst[0]) ? burst_len : 5'd0;
+
+// A buffered write burst continues if the next transfer is the next beat of it (or a BUSY)
+assign wr_continues           = hsel & hwrite & ((htrans == `AHB_TRANS_SEQ) | (htrans == `AHB_TRANS_BUSY));
+
+// The memory model won't stall on any access
 assign hready                 = 1'b1;
 
-assign hrdata                 = mem_readdatavalid ? mem_readdata : {DATAWIDTH{1'bx}};
+assign hrdata                 = rd_phase ? rd_data : {DATAWIDTH{1'bx}};
 
 // ---------------------------------------------------------
 // Synchronous process
@@ -99,50 +137,72 @@ always @(posedge hclk or negedge hresetn)
 begin
   if (hresetn == 1'b0)
   begin
-    mem_write_phase           <= 1'b0;
+    rd_phase                  <= 1'b0;
+    rd_burst                   = 1'b0;
+    rd_idx                     = 4'h0;
+    wr_phase                   = 1'b0;
+    wr_len                     = 5'd1;
+    wr_count                   = 5'd0;
   end
   else
   begin
-     mem_write_phase          <= mem_write;
-     hwstrb_phase             <= hwstrb;
-     mem_addr_phase           <= mem_addr;
+
+    // WRITES
+
+    // Buffer the data of a write's data phase, with the byte enables from its address phase
+    if (wr_phase == 1'b1)
+    begin
+      wr_buf[wr_count[3:0]]    = hwdata;
+      wr_be[wr_count[3:0]]     = {{(32-DATAWIDTH/8){1'b0}}, hwstrb_phase};
+      wr_count                 = wr_count + 5'd1;
+    end
+
+    // Write the buffered transfers to the model when the burst is complete, or is
+    // ended early. SINGLE and undefined length INCR transfers are written as they arrive.
+    if (wr_count != 5'd0 && (wr_count == wr_len || ~wr_continues))
+    begin
+      `MEMWRITEBURST(wr_addr, wr_size, wr_count, wr_wrap, wr_buf, wr_be);
+      wr_count                 = 5'd0;
+    end
+
+    // Latch a write address phase. Beats of a defined length burst after the first
+    // are located from the burst's start address.
+    if (active_access == 1'b1 && hwrite == 1'b1 && (htrans == `AHB_TRANS_NONSEQ || wr_len == 5'd1))
+    begin
+      wr_addr                  = haddr;
+      wr_size                  = hsize;
+      wr_len                   = (htrans == `AHB_TRANS_NONSEQ) ? burst_len  : 5'd1;
+      wr_wrap                  = (htrans == `AHB_TRANS_NONSEQ) ? burst_wrap : 5'd0;
+      wr_count                 = 5'd0;
+    end
+
+    hwstrb_phase               = hwstrb;
+    wr_phase                   = active_access & hwrite;
+
+    // READS
+
+    // At the start of a defined length burst, the whole burst is read from the model,
+    // and each beat's data is then returned from the buffer. SINGLE and undefined length
+    // INCR transfers are read from the model one at a time.
+    if (active_access == 1'b1 && hwrite == 1'b0)
+    begin
+      if (htrans == `AHB_TRANS_NONSEQ || rd_burst == 1'b0)
+      begin
+        `MEMREADBURST(haddr, hsize, (htrans == `AHB_TRANS_NONSEQ) ? burst_len  : 5'd1,
+                                    (htrans == `AHB_TRANS_NONSEQ) ? burst_wrap : 5'd0, rd_buf);
+        rd_burst               = (htrans == `AHB_TRANS_NONSEQ) & burst_defined;
+        rd_idx                 = 4'h0;
+      end
+      else
+      begin
+        rd_idx                 = rd_idx + 4'h1;
+      end
+
+      rd_data                 <= rd_buf[rd_idx];
+    end
+
+    rd_phase                  <= active_access & ~hwrite;
   end
 end
 
-// ---------------------------------------------------------
-// Core memory model
-// ---------------------------------------------------------
-
-  mem_model #(.EN_READ_QUEUE(0), .REG_READ_OVERLAP(1)) mem
-  (
-    .clk                      (hclk),
-    .rst_n                    (hresetn),
-
-    .address                  (mem_addr_rw),
-    .byteenable               (hwstrb_phase),
-    .write                    (mem_write_phase),
-    .writedata                (hwdata),
-    .read                     (mem_read),
-    .readdata                 (mem_readdata),
-    .readdatavalid            (mem_readdatavalid),
-
-    .rx_waitrequest           (),
-    .rx_burstcount            (12'h000),
-    .rx_address               (haddr),
-    .rx_read                  (1'b0),
-    .rx_readdata              (),
-    .rx_readdatavalid         (),
-
-    .tx_waitrequest           (),
-    .tx_burstcount            (12'h000),
-    .tx_address               ({ADDRWIDTH{1'b0}}),
-    .tx_write                 (1'b0),
-    .tx_writedata             ({DATAWIDTH{1'b0}}),
-    .tx_byteenable            ({DATAWIDTH/8{1'b0}}),
-
-    .wr_port_valid            (1'b0),
-    .wr_port_data             ({DATAWIDTH{1'b0}}),
-    .wr_port_addr             ({ADDRWIDTH{1'b0}})
-  );
-
-endmodule
\ No newline at end of file
+endmodule
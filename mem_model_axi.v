@@ -8,7 +8,11 @@
 //  Standard   : Verilog 2001
 // -----------------------------------------------------------------------------
 //  Description:
-//  A Verilog AXI subordinate wrapper around mem_model
+//  A Verilog AXI subordinate wrapper around mem_model. When EN_TIMING_MODEL
+//  is non-zero, commands are passed to the C timing model instance
+//  TIMING_INST, and read bursts and write responses are issued only when the
+//  model reports them ready, allowing multiple outstanding and reordered
+//  transactions.
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2024 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -28,6 +32,14 @@
 //
 // -----------------------------------------------------------------------------
 
+`ifdef MEM_MODEL_SV
+`define MEMTIMINGSUBMIT       MemTimingSubmit
+`define MEMTIMINGPOLL         MemTimingPoll
+`else
+`define MEMTIMINGSUBMIT       $memtimingsubmit
+`define MEMTIMINGPOLL         $memtimingpoll
+`endif
+
 module mem_model_axi
 # (parameter
     ADDRWIDTH                 = 32,
@@ -35,7 +47,9 @@ module mem_model_axi
     ID_W_WIDTH                = 4,
     ID_R_WIDTH                = 4,
     CMDQ_DEPTH                = 8,
-    DATAQ_DEPTH               = 64
+    DATAQ_DEPTH               = 64,
+    EN_TIMING_MODEL           = 0,
+    TIMING_INST               = 0
 )
 (
     input                     clk,
@@ -116,11 +130,47 @@ wire [DATAWIDTH+DATAWIDTH/8-1:0]      w_q_rdata;
 reg                                   hold_rvalid;
 reg  [DATAWIDTH-1:0]                  hold_rdata;
 
+reg  [ID_W_WIDTH-1:0]                 bid_int;
+reg  [ID_R_WIDTH-1:0]                 rid_int;
+
+wire                                  av_tx_last;
+wire                                  ar_q_read;
+wire [ID_W_WIDTH-1:0]                 aw_q_id;
+wire [ID_R_WIDTH-1:0]                 ar_q_id;
+
+// Timing model state
+reg  [31:0]                           cycle_count;
+reg                                   ar_submitted;
+reg                                   rd_cmd_valid;
+reg  [ADDRWIDTH-1:0]                  rd_cmd_addr;
+reg  [7:0]                            rd_cmd_len;
+reg  [ID_R_WIDTH-1:0]                 rd_cmd_id;
+reg                                   wr_pend_valid;
+reg  [ADDRWIDTH-1:0]                  wr_pend_addr;
+reg  [7:0]                            wr_pend_len;
+reg  [2:0]                            wr_pend_size;
+reg  [ID_W_WIDTH-1:0]                 wr_pend_id;
+
+// Addresses zero extended to 64 bits for the timing model
+wire [63:0]                           ar_q_addr64;
+wire [63:0]                           wr_pend_addr64;
+
+integer                               t_accepted;
+integer                               t_valid;
+integer                               t_id;
+integer                               t_addr_hi;
+integer                               t_addr;
+integer                               t_len;
+
 initial
 begin
   bvalid                      <= 1'b0;
   tx_burst_counter            <= 12'h000;
   rx_burst_counter            <= 12'h000;
+  cycle_count                 <= 32'h00000000;
+  ar_submitted                <= 1'b0;
+  rd_cmd_valid                <= 1'b0;
+  wr_pend_valid               <= 1'b0;
 end
 
 // ---------------------------------------------------------
@@ -149,11 +199,24 @@ assign rdata                  = (hold_rvalid == 1'b1)      ? hold_rdata  :
 // Read valid when data memory read valid, or read response stalled
 assign rvalid                 = av_readdatavalid | hold_rvalid;
 assign rlast                  = rvalid & (rx_burst_counter <= 1);
+assign rid                    = rid_int;
+
+// WRITE RESPONSE PORT LOGIC
+assign bid                    = bid_int;
 
 // MEMORY ACCESS LOGIC
 
-assign av_rx_address          = ar_q_rdata[ADDRWIDTH-1:0];
-assign av_rx_burstcount       = {4'h0, ar_q_rdata[ADDRWIDTH+12:ADDRWIDTH+5]} + 12'h001;
+assign aw_q_id                = aw_q_rdata[ADDRWIDTH+13+ID_W_WIDTH-1:ADDRWIDTH+13];
+assign ar_q_id                = ar_q_rdata[ADDRWIDTH+13+ID_R_WIDTH-1:ADDRWIDTH+13];
+
+assign ar_q_addr64            = ar_q_rdata[ADDRWIDTH-1:0];
+assign wr_pend_addr64         = wr_pend_addr;
+
+// With the timing model, read bursts come from the command returned by the model
+// rather than directly from the read address queue
+assign av_rx_address          = (EN_TIMING_MODEL != 0) ? rd_cmd_addr       : ar_q_rdata[ADDRWIDTH-1:0];
+assign av_rx_burstcount       = (EN_TIMING_MODEL != 0) ? {4'h0, rd_cmd_len} + 12'h001 :
+                                                         {4'h0, ar_q_rdata[ADDRWIDTH+12:ADDRWIDTH+5]} + 12'h001;
 
 assign av_tx_address          =  aw_q_rdata[ADDRWIDTH-1:0];
 assign av_tx_burstcount       = {4'h0, aw_q_rdata[ADDRWIDTH+12:ADDRWIDTH+5]} + 12'h001;
@@ -161,11 +224,20 @@ assign av_tx_burstcount       = {4'h0, aw_q_rdata[ADDRWIDTH+12:ADDRWIDTH+5]} + 1
 assign av_byteenable          = w_q_rdata[DATAWIDTH+DATAWIDTH/8-1:DATAWIDTH];
 assign av_writedata           = w_q_rdata[DATAWIDTH-1:0];
 
-// Write if a write address/data ready and not stalled on write response
-assign av_write               = ~aw_q_empty & ~w_q_empty & ~(bvalid & ~bready) & ~av_tx_waitrequest;
+// Write if a write address/data ready and not stalled on write response. With the
+// timing model, only stall whilst a completed burst is waiting to be accepted by the model.
+assign av_write               = ~aw_q_empty & ~w_q_empty & ~av_tx_waitrequest &
+                                ((EN_TIMING_MODEL != 0) ? ~wr_pend_valid : ~(bvalid & ~bready));
+
+// Last beat of a write burst
+assign av_tx_last             = av_write & (tx_burst_counter == 1 | av_tx_burstcount == 1);
 
 // Read if a read ready to go and not stalled on read response
-assign av_read                = ~ar_q_empty & ~(rvalid & ~rready) & ~av_rx_waitrequest;
+assign av_read                = ((EN_TIMING_MODEL != 0) ? rd_cmd_valid : ~ar_q_empty) & ~(rvalid & ~rready) & ~av_rx_waitrequest;
+
+// Read address queue is popped when a burst is issued or, with the timing model, when
+// the command at its head has been accepted by the model
+assign ar_q_read              = (EN_TIMING_MODEL != 0) ? ar_submitted : av_read;
 
 // ---------------------------------------------------------
 // Synchronous process
@@ -184,12 +256,95 @@ begin
     hold_rvalid               <= 1'b0;
     tx_burst_counter          <= 12'h000;    
     rx_burst_counter          <= 12'h000;    
+    cycle_count               <= 32'h00000000;
+    ar_submitted              <= 1'b0;
+    rd_cmd_valid              <= 1'b0;
+    wr_pend_valid             <= 1'b0;
   end
   else
   begin
-    // Set bvalid when written to memory, and hold until bready asserted
-    bvalid                    <= ((av_write & (tx_burst_counter == 1 | av_tx_burstcount == 1)) | (bvalid & ~bready)) & nreset;
-    
+    cycle_count               <= cycle_count + 32'h00000001;
+
+    if (EN_TIMING_MODEL == 0)
+    begin
+      // Set bvalid when written to memory, and hold until bready asserted
+      bvalid                  <= (av_tx_last | (bvalid & ~bready)) & nreset;
+
+      if (av_tx_last)
+      begin
+        bid_int               <= aw_q_id;
+      end
+
+      if (av_read)
+      begin
+        rid_int               <= ar_q_id;
+      end
+    end
+    else
+    begin
+      // Submit the command at the head of the read address queue. The queue is popped
+      // on the following cycle, so don't resubmit the same command whilst this happens.
+      ar_submitted            <= 1'b0;
+      if (~ar_q_empty & ~ar_submitted)
+      begin
+        `MEMTIMINGSUBMIT(TIMING_INST, 0, ar_q_id, ar_q_addr64[63:32], ar_q_addr64[31:0], ar_q_rdata[ADDRWIDTH+12:ADDRWIDTH+5] + 1,
+                         ar_q_rdata[ADDRWIDTH+4:ADDRWIDTH+2], cycle_count, t_accepted);
+        ar_submitted          <= (t_accepted != 0);
+      end
+
+      // A read command is consumed when its burst is issued to memory, and
+      // a new one fetched from the model when it has one ready
+      if (av_read)
+      begin
+        rd_cmd_valid          <= 1'b0;
+        rid_int               <= rd_cmd_id;
+      end
+
+      if (~rd_cmd_valid | av_read)
+      begin
+        `MEMTIMINGPOLL(TIMING_INST, 0, cycle_count, t_valid, t_id, t_addr_hi, t_addr, t_len);
+        if (t_valid != 0)
+        begin
+          rd_cmd_valid        <= 1'b1;
+          rd_cmd_id           <= t_id;
+          rd_cmd_addr         <= {t_addr_hi[31:0], t_addr[31:0]};
+          rd_cmd_len          <= t_len - 1;
+        end
+      end
+
+      // Hold a completed write burst until accepted by the model
+      if (av_tx_last)
+      begin
+        wr_pend_valid         <= 1'b1;
+        wr_pend_id            <= aw_q_id;
+        wr_pend_addr          <= aw_q_rdata[ADDRWIDTH-1:0];
+        wr_pend_len           <= aw_q_rdata[ADDRWIDTH+12:ADDRWIDTH+5];
+        wr_pend_size          <= aw_q_rdata[ADDRWIDTH+4:ADDRWIDTH+2];
+      end
+      else if (wr_pend_valid)
+      begin
+        `MEMTIMINGSUBMIT(TIMING_INST, 1, wr_pend_id, wr_pend_addr64[63:32], wr_pend_addr64[31:0], wr_pend_len + 1,
+                         wr_pend_size, cycle_count, t_accepted);
+        wr_pend_valid         <= (t_accepted == 0);
+      end
+
+      // Return a write response when the model has one ready
+      if (bvalid & bready)
+      begin
+        bvalid                <= 1'b0;
+      end
+
+      if (~bvalid | bready)
+      begin
+        `MEMTIMINGPOLL(TIMING_INST, 1, cycle_count, t_valid, t_id, t_addr_hi, t_addr, t_len);
+        if (t_valid != 0)
+        begin
+          bvalid              <= 1'b1;
+          bid_int             <= t_id;
+        end
+      end
+    end
+
     // Hold rvalid if read response port stalled
     hold_rvalid               <= rvalid & ~rready & nreset;
     
@@ -278,7 +433,7 @@ end
   mem_model_q
   #(
     .DEPTH                    (CMDQ_DEPTH),
-    .WIDTH                    (ADDRWIDTH+2+3+8+ID_W_WIDTH)
+    .WIDTH                    (ADDRWIDTH+2+3+8+ID_R_WIDTH)
   ) ar_q
   (
     .clk                      (clk),
@@ -288,7 +443,7 @@ end
     .wdata                    (ar_q_wdata),
     .full                     (ar_q_full),
 
-    .read                     (av_read),
+    .read                     (ar_q_read),
     .rdata                    (ar_q_rdata),
     .empty                    (ar_q_empty),
 
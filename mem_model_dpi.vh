@@ -29,4 +29,52 @@ import "DPI-C" function void MemWrite  (input  int address,
 
 import "DPI-C" function void MemRead   (input  int address,
                                         output int data,
-                                        input  int be);
\ No newline at end of file
+                                        input  int be);
+
+import "DPI-C" function void MemReadBurst  (input  int address,
+                                            input  int size,
+                                            input  int len,
+                                            input  int wrap,
+                                            output int data[16]);
+
+import "DPI-C" function void MemWriteBurst (input  int address,
+                                            input  int size,
+                                            input  int len,
+                                            input  int wrap,
+                                            input  int data[16],
+                                            input  int be[16]);
+
+import "DPI-C" function void MemTimingSubmit (input  int inst,
+                                              input  int wnr,
+                                              input  int id,
+                                              input  int addr_hi,
+                                              input  int address,
+                                              input  int len,
+                                              input  int size,
+                                              input  int cycle,
+                                              output int accepted);
+
+import "DPI-C" function void MemTimingPoll   (input  int inst,
+                                              input  int wnr,
+                                              input  int cycle,
+                                              output int valid,
+                                              output int id,
+                                              output int addr_hi,
+                                              output int address,
+                                              output int len);
+
+import "DPI-C" function void MemFillTask     (input  int node,
+                                              input  int address,
+                                              input  int pattern,
+                                              input  int len);
+
+import "DPI-C" function void MemCopyTask     (input  int dst_node,
+                                              input  int dst,
+                                              input  int src_node,
+                                              input  int src,
+                                              input  int len);
+
+import "DPI-C" function void MemHostTime     (output int usec);
+
+import "DPI-C" function void MemProfileCycleTask (input  int cycle_hi,
+                                                  input  int cycle);
@@ -50,6 +50,34 @@ package mem_model_pkg is
   );
   attribute foreign of MemRead : procedure is "MemRead VProc.so";
 
+  procedure MemFillTask (
+    node      : in  integer;
+    address   : in  integer;
+    pattern   : in  integer;
+    len       : in  integer
+  );
+  attribute foreign of MemFillTask : procedure is "MemFillTask VProc.so";
+
+  procedure MemCopyTask (
+    dst_node  : in  integer;
+    dst       : in  integer;
+    src_node  : in  integer;
+    src       : in  integer;
+    len       : in  integer
+  );
+  attribute foreign of MemCopyTask : procedure is "MemCopyTask VProc.so";
+
+  procedure MemHostTime (
+    usec      : out integer
+  );
+  attribute foreign of MemHostTime : procedure is "MemHostTime VProc.so";
+
+  procedure MemProfileCycleTask (
+    cycle_hi  : in  integer;
+    cycle     : in  integer
+  );
+  attribute foreign of MemProfileCycleTask : procedure is "MemProfileCycleTask VProc.so";
+
 end;
 
 package body mem_model_pkg is
@@ -72,4 +100,40 @@ package body mem_model_pkg is
     report "ERROR: foreign subprogram out_params not called";
   end;
 
+  procedure MemFillTask (
+    node      : in  integer;
+    address   : in  integer;
+    pattern   : in  integer;
+    len       : in  integer
+  ) is
+  begin
+    report "ERROR: foreign subprogram out_params not called";
+  end;
+
+  procedure MemCopyTask (
+    dst_node  : in  integer;
+    dst       : in  integer;
+    src_node  : in  integer;
+    src       : in  integer;
+    len       : in  integer
+  ) is
+  begin
+    report "ERROR: foreign subprogram out_params not called";
+  end;
+
+  procedure MemHostTime (
+    usec      : out integer
+  ) is
+  begin
+    report "ERROR: foreign subprogram out_params not called";
+  end;
+
+  procedure MemProfileCycleTask (
+    cycle_hi  : in  integer;
+    cycle     : in  integer
+  ) is
+  begin
+    report "ERROR: foreign subprogram out_params not called";
+  end;
+
 end;
\ No newline at end of file
@@ -10,13 +10,52 @@
 // INCLUDES
 // -------------------------------------------------------------------------
 
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
 #include "mem.h"
+#include "mem_shm.h"
+#include "mem_prof.h"
+#include "mem_dirty.h"
+#include "mem_uninit.h"
+#include "mem_gen.h"
+#include "mem_wb.h"
 
 // -------------------------------------------------------------------------
 // STATICS
 // -------------------------------------------------------------------------
 
-static pPrimaryTbl_t PrimaryTable[VP_MAX_NODES];
+static PrimaryHash_t PrimaryTable[VP_MAX_NODES];
+static int           NodeMode[VP_MAX_NODES];
+static bool          Profiling = false;
+static bool          DirtyTracking[VP_MAX_NODES];
+static bool          UninitCheck[VP_MAX_NODES];
+
+// Sequential stream detection
+static uint32_t      StreamBatch[VP_MAX_NODES];     // Pages to read ahead (0 = off)
+static uint64_t      StreamLast[VP_MAX_NODES];      // Last page number accessed
+static uint64_t      StreamAhead[VP_MAX_NODES];     // First page number not yet read ahead
+static uint32_t      StreamRun[VP_MAX_NODES];       // Consecutive ascending page accesses
+
+// Flat node mappings
+static char*         FlatBase[VP_MAX_NODES];
+static uint64_t      FlatAddr[VP_MAX_NODES];
+static uint64_t      FlatSize[VP_MAX_NODES];
+
+// Contents of unallocated pages, as returned by reads
+static const char    ZeroPage[TABLESIZE];
+
+#if !defined(__SSE4_2__)
+static uint32_t      Crc32cTable[256];
+#endif
 
 // -------------------------------------------------------------------------
 // InitialiseMem()
@@ -27,24 +66,65 @@ static pPrimaryTbl_t PrimaryTable[VP_MAX_NODES];
 
 void InitialiseMem (int node)
 {
-    PrimaryTable[node] = NULL;
+    SyncMemWriteBehind();
+
+    PrimaryTable[node].tbl  = NULL;
+    PrimaryTable[node].size = 0;
+    PrimaryTable[node].used = 0;
 }
 
 // -------------------------------------------------------------------------
-// InitialisePrimaryTable()
+// SetNodeMode()
 //
-// Invalidates all entries in the memory primary table
+// Select the page store backing for a node (MEM_NODE_xxx)
 //
 // -------------------------------------------------------------------------
 
-static void InitialisePrimaryTable (const pPrimaryTbl_t table)
+void SetNodeMode (const uint32_t node, const int mode)
 {
-    int i;
+    SyncMemWriteBehind();
 
-    for (i = 0; i < TABLESIZE; i++)
-    {
-        table[i].valid = false;
-    }
+    NodeMode[node] = mode;
+}
+
+// -------------------------------------------------------------------------
+// GetNodeMode()
+//
+// Return the page store backing for a node
+//
+// -------------------------------------------------------------------------
+
+int GetNodeMode (const uint32_t node)
+{
+    return NodeMode[node];
+}
+
+// -------------------------------------------------------------------------
+// SetMemProfiling()
+//
+// Turn on or off passing of page accesses to the profiler
+//
+// -------------------------------------------------------------------------
+
+void SetMemProfiling (const bool enable)
+{
+    SyncMemWriteBehind();
+
+    Profiling = enable;
+}
+
+// -------------------------------------------------------------------------
+// SetMemDirtyTracking()
+//
+// Turn on or off passing of a node's writes to dirty page tracking
+//
+// -------------------------------------------------------------------------
+
+void SetMemDirtyTracking (const uint32_t node, const bool enable)
+{
+    SyncMemWriteBehind();
+
+    DirtyTracking[node] = enable;
 }
 
 // -------------------------------------------------------------------------
@@ -54,7 +134,7 @@ static void InitialisePrimaryTable (const pPrimaryTbl_t table)
 //
 // -------------------------------------------------------------------------
 
-static void InitialiseTable (char **table)
+static void InitialiseTable (pMemPage_t *table)
 {
     int i;
 
@@ -65,386 +145,1645 @@ static void InitialiseTable (char **table)
 }
 
 // -------------------------------------------------------------------------
-// bitrev()
+// GenHash64()
 //
-// An efficient bit reverse, up to 32 bits.
+// Hash a region address into a primary table index
 //
 // -------------------------------------------------------------------------
 
-static uint32_t bitrev(const uint32_t Data, const int bits)
+static inline uint64_t GenHash64(const uint64_t addr)
 {
-    unsigned long result = Data;
-    int i;
-
-    // Compare each of the bottom bits with reflected top bits
-    for (i = 0; i < bits/2; i++)
-    {
-        // If top and bottom bits different, invert both bits
-        if (((result >> (bits-1-i*2)) ^ result) & (1 << i))
-        {
-            result ^= (1 << i) | (1 << (bits-1-i));
-        }
-    }
-
-    return result & ((1 << bits) - 1);
+    return MemHash64(addr >> PRIMARY_REGION_BITS);
 }
 
 // -------------------------------------------------------------------------
-// GenHash12()
+// PageEntrySlot()
 //
-// A cheap and cheerful hash
+// Find the entry for a page in a page keyed table, or the unused
+// entry where it would be added
 //
 // -------------------------------------------------------------------------
 
-static uint32_t GenHash12(const uint64_t addr)
+static pPageEntry_t PageEntrySlot(const pPageEntry_t tbl, const uint64_t size, const uint64_t page_addr)
 {
-    uint64_t munge = 0;
+    uint64_t idx = MemHash64(page_addr >> 12) & (size - 1);
 
-    munge ^= (addr >> 52) & 0xfffULL;
-    munge ^= (addr >> 40) & 0xfffULL;
-    munge ^= (addr >> 32) & 0xffULL;
-    munge ^= (addr >> 24) & 0xffULL;
+    while (tbl[idx].val != 0 && tbl[idx].addr != page_addr)
+    {
+        idx = (idx + 1) & (size - 1);
+    }
 
-    return bitrev((uint32_t) (munge & 0xfffULL), 12);
+    return &tbl[idx];
 }
 
 // -------------------------------------------------------------------------
-// WriteRamByteBlock()
+// ResizePageTable()
 //
-// Write a block of data to memory
+// Double the size of a page keyed table, rehashing the current entries
 //
 // -------------------------------------------------------------------------
 
-void WriteRamByteBlock(const uint64_t addr, const PktData_t *data, const int fbe, int const lbe, const int length, const uint32_t node)
+static int ResizePageTable(const pPageTable_t pt)
 {
-    uint32_t pidx, sidx, offset;
-    int idx;
-
-    idx = pidx = GenHash12(addr);
-    sidx = (addr >> 12) & TABLEMASK;
-    offset = addr & TABLEMASK;
+    pPageEntry_t new_tbl;
+    uint64_t     new_size = pt->size ? pt->size * 2 : PAGE_TABLE_INIT_SIZE;
+    uint64_t     idx;
 
-    if ((addr & ~TABLEMASK) != ((addr + length - 1) & ~TABLEMASK))
+    if ((new_tbl = calloc(new_size, sizeof(PageEntry_t))) == NULL)
     {
-        printf("WriteRamByteBlock: ***Error --- block write crosses 4K boundary (addr=0x%llx len=0x%x\n", (long long unsigned)addr, length);
+        printf("ResizePageTable: ***Error --- failed to allocate page table memory\n");
+        return MEM_BAD_STATUS;
     }
 
-    // No primary table, so allocate some space for one and initialise
-    if (PrimaryTable[node] == NULL)
+    for (idx = 0; idx < pt->size; idx++)
     {
-        if ((PrimaryTable[node] = malloc(TABLESIZE * sizeof(PrimaryTbl_t))) == NULL)
+        if (pt->tbl[idx].val != 0)
         {
-            printf("WriteRamByteBlock: ***Error --- failed to allocate primary table memory\n");
+            *PageEntrySlot(new_tbl, new_size, pt->tbl[idx].addr) = pt->tbl[idx];
         }
-        InitialisePrimaryTable(PrimaryTable[node]);
     }
 
-    // Whilst we have a collision, increment primary offset until an invalid entry, or we matched address
-    while (PrimaryTable[node][pidx].valid && PrimaryTable[node][pidx].addr != (addr & 0xffffffffff000000ULL))
-    {
-        pidx = (pidx+1) % TABLESIZE;
+    free(pt->tbl);
 
-        // If we have searched through the whole table....
-        if (pidx == idx)
-        {
-            printf("WriteRamByteBlock: ***Error --- ran out of primary table space\n");
-        }
-    }
+    pt->tbl  = new_tbl;
+    pt->size = new_size;
+    pt->last = NULL;
 
-    // If first time we have written to this block, validate it
-    if (!PrimaryTable[node][pidx].valid)
-    {
-        PrimaryTable[node][pidx].valid = true;
-        PrimaryTable[node][pidx].addr = (addr & 0xffffffffff000000ULL);
-        PrimaryTable[node][pidx].p = NULL;
-    }
+    return MEM_GOOD_STATUS;
+}
 
-    // No secondary table, so allocate some space for one and initialise
-    if (PrimaryTable[node][pidx].p == NULL)
+// -------------------------------------------------------------------------
+// FindPageEntry()
+//
+// Return the entry for a page in a page keyed table, or NULL if the
+// page has none. Lookups of the same page as the last are short cut.
+//
+// -------------------------------------------------------------------------
+
+pPageEntry_t FindPageEntry(const pPageTable_t pt, const uint64_t page_addr)
+{
+    pPageEntry_t entry;
+
+    if (pt->last != NULL && pt->last->addr == page_addr)
     {
-        if ((PrimaryTable[node][pidx].p = malloc(TABLESIZE * sizeof(uint32_t *))) == NULL)
-        {
-            printf("WriteRamByteBlock: ***Error --- failed to allocate secondary table memory\n");
-            //VWrite(PVH_FATAL, 0, 0, node);
-        }
-        InitialiseTable(PrimaryTable[node][pidx].p);
+        return pt->last;
     }
 
-    // No memory block allocated, so allocate some space
-    if ((PrimaryTable[node][pidx].p)[sidx] == NULL)
+    if (pt->tbl == NULL)
     {
-#ifdef MEM_ZERO_NEW_PAGES
-        if (((PrimaryTable[node][pidx].p)[sidx] = calloc(TABLESIZE, 1)) == NULL)
-#else
-        if (((PrimaryTable[node][pidx].p)[sidx] = malloc(TABLESIZE)) == NULL)
-#endif     
-        {
-            printf("WriteRamByteBlock: ***Error --- failed to allocate memory\n");
-        }
+        return NULL;
     }
 
-    for (idx = 0; idx < length; idx++)
+    entry = PageEntrySlot(pt->tbl, pt->size, page_addr);
+
+    if (entry->val == 0)
     {
-        if ( (idx < 4 && ((1<<idx) & fbe)) ||
-             (idx >= (length-4) && ((1<<(4-(length-idx))) & lbe)) ||
-             (idx >= 4 && idx < (length-4)))
-        {
-            ((char *)((PrimaryTable[node][pidx].p)[sidx]))[idx+offset] = data[idx];
-        }
+        return NULL;
     }
+
+    pt->last = entry;
+
+    return entry;
 }
 
 // -------------------------------------------------------------------------
-// ReadRamByteBlock()
+// AddPageEntry()
 //
-// Read a block of data from memory.
+// Set the (non-zero) value of a page's entry in a page keyed table,
+// adding the entry if not present. Returns NULL if the table could
+// not be grown.
 //
 // -------------------------------------------------------------------------
 
-int ReadRamByteBlock(const uint64_t addr, PktData_t *data, const int length, const uint32_t node)
+pPageEntry_t AddPageEntry(const pPageTable_t pt, const uint64_t page_addr, const uint64_t val)
 {
-    uint32_t pidx, sidx, offset;
-    int idx, len;
+    pPageEntry_t entry;
 
-    idx = pidx = GenHash12(addr);
-    sidx = (addr >> 12) & TABLEMASK;
-    offset = addr & TABLEMASK;
-
-    if ((addr & ~TABLEMASK) != ((addr + length-1) & ~TABLEMASK))
+    // Keep the table no more than half full
+    if (pt->used * 2 >= pt->size && ResizePageTable(pt) != MEM_GOOD_STATUS)
     {
-        printf("ReadRamByteBlock: ***Error --- block read crosses 4K boundary\n");
+        return NULL;
     }
 
-    if (PrimaryTable[node] == NULL)
-    {
-        Debugprintf("ReadRamByteBlock: ***Error --- reading from uninitialised primary table\n");
-        return MEM_BAD_STATUS;
-    }
+    entry = PageEntrySlot(pt->tbl, pt->size, page_addr);
 
-    // Whilst we have detected a collision, increment primary offset until an invalid entry or we matched address
-    while (PrimaryTable[node][pidx].valid && PrimaryTable[node][pidx].addr != (addr & 0xffffffffff000000ULL))
+    if (entry->val == 0)
     {
-        pidx = (pidx+1) % TABLESIZE;
-
-        // If we searched the whole table...
-        if (pidx == idx)
-        {
-            printf("ReadRamByteBlock: ***Error --- address does not exist in primary table\n");
-        }
+        entry->addr = page_addr;
+        pt->used++;
     }
 
-    // No secondary table, so flag an error
-    if (PrimaryTable[node][pidx].p == NULL)
-    {
-        Debugprintf("ReadRamByteBlock: ***Error --- reading from uninitialised secondary table\n");
-        return MEM_BAD_STATUS;
-    }
+    entry->val = val;
+    pt->last   = entry;
 
-    // No memory block allocated, so flag an error
-    if ((PrimaryTable[node][pidx].p)[sidx] == NULL)
-    {
-        Debugprintf("ReadRamByteBlock: ***Error --- reading from uninitialised memory block\n");
-        return MEM_BAD_STATUS;
-    }
+    return entry;
+}
 
-    for (idx = 0; idx < length; idx++)
+// -------------------------------------------------------------------------
+// ClearPageTable()
+//
+// Remove all the entries of a page keyed table, keeping its memory
+//
+// -------------------------------------------------------------------------
+
+void ClearPageTable(const pPageTable_t pt)
+{
+    if (pt->tbl != NULL)
     {
-        data[idx] = ((char *)(PrimaryTable[node][pidx].p)[sidx])[idx+offset] & 0xff;
+        memset(pt->tbl, 0, pt->size * sizeof(PageEntry_t));
     }
 
-    return MEM_GOOD_STATUS;
+    pt->used = 0;
+    pt->last = NULL;
 }
 
 // -------------------------------------------------------------------------
-// WriteRamByte()
+// FreePageTable()
 //
-// Write a data byte to memory.
+// Free the memory of a page keyed table, leaving it empty
 //
 // -------------------------------------------------------------------------
 
-void WriteRamByte(const uint64_t inaddr, const uint32_t data, const uint32_t node)
+void FreePageTable(const pPageTable_t pt)
 {
-    uint64_t addr;
-    int addr_lo, fbe;
-    PktData_t buf[4];
-
-    addr = inaddr & ~3ULL;
-    addr_lo = (int)(inaddr & 3ULL);
-    fbe  = 0x1 << addr_lo;
-    buf[addr_lo] = data & 0xff;
+    free(pt->tbl);
 
-    WriteRamByteBlock (addr, buf, fbe, 0, 4, node);
+    memset(pt, 0, sizeof(PageTable_t));
 }
 
 // -------------------------------------------------------------------------
-// WriteRamHWord()
+// ResizePrimaryTable()
 //
-// Write a data half word to memory.
+// Allocate a new primary table for a node of the given size (a power
+// of 2), and rehash any entries from the old table into it.
 //
 // -------------------------------------------------------------------------
 
-void WriteRamHWord (const uint64_t addr, const uint32_t data, const int le, const uint32_t node)
+static int ResizePrimaryTable (const uint32_t node, const uint32_t size)
 {
-    uint32_t data_out;
-    int addr_lo, fbe;
-    PktData_t buf[4];
-    int i;
+    pPrimaryHash_t pt = &PrimaryTable[node];
+    pPrimaryTbl_t  old_tbl  = pt->tbl;
+    uint32_t       old_size = pt->size;
+    uint32_t       i, idx;
 
-    addr_lo  =  (int)(addr & 2ULL);
-    fbe      = 0x3 << addr_lo;
-    data_out = (addr_lo) ? (data << 16) : data;
+    if ((pt->tbl = calloc(size, sizeof(PrimaryTbl_t))) == NULL)
+    {
+        printf("ResizePrimaryTable: ***Error --- failed to allocate primary table memory\n");
+        pt->tbl = old_tbl;
+        return MEM_BAD_STATUS;
+    }
 
-    for (i = 0; i < 4; i++)
+    pt->size = size;
+
+    for (i = 0; i < old_size; i++)
     {
-        buf[i] = (le ? (data_out >> (i*8))  & 0xffffUL: (data_out >> ((3-i)*8))) & 0xff;
+        if (old_tbl[i].valid)
+        {
+            for (idx = GenHash64(old_tbl[i].addr) & (size-1); pt->tbl[idx].valid; idx = (idx+1) & (size-1))
+                ;
+            pt->tbl[idx] = old_tbl[i];
+        }
     }
 
-    WriteRamByteBlock (addr & ~3ULL, buf, fbe, 0x0, 4, node);
+    free(old_tbl);
+
+    return MEM_GOOD_STATUS;
 }
 
 // -------------------------------------------------------------------------
-// WriteRamWord()
+// GetPrimaryEntry()
 //
-// Write a data word to memory.
+// Returns the primary table entry for the 16MB region containing addr.
+// If alloc is set, a new entry is created if not present, growing
+// the table when it becomes half full, or if the probe length to
+// find a free entry exceeds PRIMARY_MAX_PROBE, else NULL is
+// returned if there is no entry.
 //
 // -------------------------------------------------------------------------
 
-void WriteRamWord (const uint64_t addr, const uint32_t data, const int le, const uint32_t node)
+static pPrimaryTbl_t GetPrimaryEntry (const uint64_t addr, const uint32_t node, const bool alloc)
 {
-    PktData_t buf[4];
-    int i;
+    pPrimaryHash_t pt = &PrimaryTable[node];
+    uint64_t       region = addr & PRIMARY_REGION_MASK;
+    uint32_t       idx, probe;
 
-    for (i = 0; i < 4; i++)
+    // No primary table, so allocate some space for one
+    if (pt->tbl == NULL)
     {
-        buf[i] = (le ? (data >> (i*8)) : (data >> ((3-i)*8))) & 0xff;
+        if (!alloc)
+        {
+            Debugprintf("GetPrimaryEntry: ***Error --- reading from uninitialised primary table\n");
+            return NULL;
+        }
+
+        if (ResizePrimaryTable(node, PRIMARY_INIT_SIZE) != MEM_GOOD_STATUS)
+        {
+            return NULL;
+        }
     }
 
-    WriteRamByteBlock (addr & ~3ULL, buf, 0xf, 0x0, 4, node);
+    while (true)
+    {
+        // Whilst we have a collision, increment primary offset until an invalid entry, or we matched address
+        for (idx = GenHash64(region) & (pt->size-1), probe = 0; pt->tbl[idx].valid; idx = (idx+1) & (pt->size-1), probe++)
+        {
+            if (pt->tbl[idx].addr == region)
+            {
+                return &pt->tbl[idx];
+            }
+        }
+
+        if (!alloc)
+        {
+            return NULL;
+        }
+
+        // Grow the table, and search again, if too full or the probe was too long
+        if ((2 * (pt->used+1) > pt->size || probe > PRIMARY_MAX_PROBE) && pt->size < PRIMARY_MAX_SIZE)
+        {
+            if (ResizePrimaryTable(node, pt->size * 2) == MEM_GOOD_STATUS)
+            {
+                continue;
+            }
+        }
+
+        if (pt->used == pt->size - 1)
+        {
+            printf("GetPrimaryEntry: ***Error --- ran out of primary table space\n");
+            return NULL;
+        }
+
+        pt->tbl[idx].valid = true;
+        pt->tbl[idx].addr  = region;
+        pt->tbl[idx].p     = NULL;
+        pt->used++;
+
+        return &pt->tbl[idx];
+    }
 }
 
 // -------------------------------------------------------------------------
-// WriteRamDWord()
+// SetMemStream()
 //
-// Write a double data word (64 bits) to memory.
+// Turn on sequential stream detection for a heap backed node, reading
+// ahead batch pages at a time once a stream is detected, or turn it
+// off if batch is 0
 //
 // -------------------------------------------------------------------------
 
-void WriteRamDWord (const uint64_t addr, const uint64_t data, const int le, const uint32_t node)
+void SetMemStream (const uint32_t node, const uint32_t batch)
 {
-    PktData_t buf[8];
-    int i;
-
-    for (i = 0; i < 8; i++)
-    {
-        buf[i] = (PktData_t) (le ? (data >> (i*8)) : (data >> ((7-i)*8))) & 0xffULL;
-    }
+    SyncMemWriteBehind();
 
-    WriteRamByteBlock (addr & ~7ULL, buf, 0xf, 0xf, 8, node);
+    StreamBatch[node] = batch;
+    StreamLast[node]  = 0;
+    StreamAhead[node] = 0;
+    StreamRun[node]   = 0;
 }
 
 // -------------------------------------------------------------------------
-// ReadRamByte()
+// PrefetchPage()
 //
-// Read a byte from memory
+// Make the existing page containing addr resident ahead of it being
+// accessed. Pages that do not exist are left to be created on first
+// access, as before.
 //
 // -------------------------------------------------------------------------
 
-uint32_t ReadRamByte (const uint64_t addr, const uint32_t node)
+static void PrefetchPage(const uint64_t addr, const uint32_t node)
 {
-    PktData_t buf[4];
-    int i;
+    pPrimaryTbl_t entry;
+    pMemPage_t page;
 
-    // If ReadRamByteBlock fails, return 0
-    if (ReadRamByteBlock (addr & ~3ULL, buf, 4, node))
+    if ((entry = GetPrimaryEntry(addr, node, false)) != NULL && entry->p != NULL &&
+        (page = (entry->p)[(addr >> 12) & TABLEMASK]) != NULL && page->data == NULL)
     {
-        return 0;
+        PrefetchMemPage(page);
     }
-
-    i = (int)(addr & 3ULL);
-
-    return buf[i];
 }
 
 // -------------------------------------------------------------------------
-// ReadRamHWord()
+// DetectStream()
 //
-// Read a half word from memory
+// Track a heap backed node's page accesses, and when they form an
+// ascending sequential stream, bring in the next batch of pages before
+// they are accessed. For a stream of writes, the page buffer pool is
+// also topped up, ready for the new pages the stream will create.
 //
 // -------------------------------------------------------------------------
 
-uint32_t ReadRamHWord (const uint64_t addr, const int le, const uint32_t node)
+static void DetectStream(const uint64_t addr, const uint32_t node, const bool write)
 {
-    PktData_t buf[4];
-    uint32_t data = 0;
-    int addr_lo = addr & 0x2;
-    int i;
+    uint64_t pnum  = addr >> 12;
+    uint64_t batch = StreamBatch[node];
+    uint64_t p;
 
-    // If ReadRamByteBlock fails, return 0
-    if (ReadRamByteBlock (addr & ~3ULL, buf, 4, node))
+    // Repeated accesses within a page neither extend nor break a stream
+    if (pnum == StreamLast[node])
     {
-        return 0;
+        return;
     }
 
-    for (i = addr_lo; i < (2+addr_lo); i++)
+    if (pnum == StreamLast[node] + 1)
     {
-        data |= (buf[i] & 0xff) << (le ? (i*8) : ((3-i)*8));
+        StreamRun[node]++;
+    }
+    else
+    {
+        StreamRun[node]   = 0;
+        StreamAhead[node] = pnum + 1;
     }
 
-    return (addr_lo) ? (data >> 16) : data;
-}
-
-// -------------------------------------------------------------------------
-// ReadRamWord()
-//
-// Read a word from memory
-//
-// -------------------------------------------------------------------------
+    StreamLast[node] = pnum;
 
-uint32_t ReadRamWord (const uint64_t addr, const int le, const uint32_t node)
-{
-    PktData_t buf[4];
-    uint32_t data = 0;
-    int i;
+    // Read ahead another batch once the stream is within half a batch of the last one
+    if (StreamRun[node] < MEM_STREAM_MIN_RUN || StreamAhead[node] > pnum + batch/2 + 1)
+    {
+        return;
+    }
 
-    // If ReadRamByteBlock fails, return 0
-    if (ReadRamByteBlock (addr & ~3ULL, buf, 4, node))
+    if (StreamAhead[node] <= pnum)
     {
-        return 0;
+        StreamAhead[node] = pnum + 1;
     }
 
-    for (i = 0; i < 4; i++)
+    for (p = StreamAhead[node]; p <= pnum + batch; p++)
     {
-        data |= (buf[i] & 0xff) << (le ? (i*8) : ((3-i)*8));
+        PrefetchPage(p << 12, node);
     }
 
-    return data;
+    StreamAhead[node] = pnum + batch + 1;
+
+    if (write)
+    {
+        FillPagePool(batch);
+    }
 }
 
 // -------------------------------------------------------------------------
-// ReadRamDWord()
+// LookupPage()
 //
-// Read a double word (64 bits) from memory
+// Returns a pointer to the 4K page containing addr. If alloc is set,
+// any missing tables and the page itself are allocated, else NULL is
+// returned if the page does not exist. Accesses are not passed to the
+// profiler or stream detection.
 //
 // -------------------------------------------------------------------------
 
-uint64_t ReadRamDWord (const uint64_t addr, const int le, const uint32_t node)
-
+static char* LookupPage(const uint64_t addr, const uint32_t node, const bool alloc)
 {
-    PktData_t buf[8];
-    uint64_t data = 0;
-    int i;
+    pPrimaryTbl_t entry;
+    pMemPage_t page;
+    uint32_t sidx;
+    int gen;
 
-    // If ReadRamByteBlock fails, return 0
-    if (ReadRamByteBlock (addr & ~7ULL, buf, 8, node))
+    if (NodeMode[node] == MEM_NODE_FLAT)
     {
-        return 0ULL;
+        if (addr - FlatAddr[node] >= FlatSize[node])
+        {
+            if (alloc)
+            {
+                printf("GetPage: ***Error --- address 0x%llx outside of flat node %d\n", (long long unsigned)addr, node);
+            }
+            return NULL;
+        }
+        return FlatBase[node] + ((addr - FlatAddr[node]) & ~TABLEMASK);
     }
 
-    for (i = 0; i < 8; i++)
+    if (NodeMode[node] == MEM_NODE_SHM)
     {
-        data |= ((uint64_t)(buf[i] & 0xff)) << (le ? (i*8) : ((7-i)*8));
+        return GetShmPage(addr, node, alloc);
     }
 
-    return data;
-}
+    sidx = (addr >> 12) & TABLEMASK;
+
+    // Pages in generated ranges are created when first read, as well as written
+    if ((entry = GetPrimaryEntry(addr, node, alloc)) == NULL &&
+        (alloc || FindMemGenerator(node, addr) == MEM_GEN_NONE || (entry = GetPrimaryEntry(addr, node, true)) == NULL))
+    {
+        return NULL;
+    }
 
+    // No secondary table, so allocate some space for one and initialise
+    if (entry->p == NULL)
+    {
+        if (!alloc && FindMemGenerator(node, addr) == MEM_GEN_NONE)
+        {
+            Debugprintf("GetPage: ***Error --- reading from uninitialised secondary table\n");
+            return NULL;
+        }
+
+        if ((entry->p = malloc(TABLESIZE * sizeof(pMemPage_t))) == NULL)
+        {
+            printf("GetPage: ***Error --- failed to allocate secondary table memory\n");
+            return NULL;
+        }
+        InitialiseTable(entry->p);
+    }
+
+    // No memory block allocated, so allocate some space
+    if ((page = (entry->p)[sidx]) == NULL)
+    {
+        gen = FindMemGenerator(node, addr);
+
+        if (!alloc && gen == MEM_GEN_NONE)
+        {
+            Debugprintf("GetPage: ***Error --- reading from uninitialised memory block\n");
+            return NULL;
+        }
+
+        if ((page = (entry->p)[sidx] = NewMemPage()) == NULL)
+        {
+            return NULL;
+        }
+
+        if (gen != MEM_GEN_NONE)
+        {
+            GenMemPage(page, addr, gen);
+        }
+    }
+    // Page shared with a cloned node, so take a copy of it before writing
+    else if (alloc && page->refs > 1)
+    {
+        if ((page = (entry->p)[sidx] = CopyMemPage(page)) == NULL)
+        {
+            return NULL;
+        }
+    }
+    // Page compressed, or spilled to file when over the memory budget, so bring it back in
+    else if (page->data == NULL && FaultMemPage(page) == NULL)
+    {
+        return NULL;
+    }
+
+    if (alloc)
+    {
+        page->flags = (page->flags & ~(MEM_PAGE_INCOMPRESSIBLE | MEM_PAGE_PREFETCHED)) | MEM_PAGE_REF | MEM_PAGE_ACCESSED | MEM_PAGE_WRITTEN;
+    }
+    else
+    {
+        page->flags = (page->flags & ~MEM_PAGE_PREFETCHED) | MEM_PAGE_REF | MEM_PAGE_ACCESSED;
+    }
+
+    return page->data;
+}
+
+// -------------------------------------------------------------------------
+// GetPage()
+//
+// Returns a pointer to the 4K page containing addr, as for LookupPage(),
+// for an access by the model's users, which is passed to the profiler
+// and stream detection.
+//
+// -------------------------------------------------------------------------
+
+static char* GetPage(const uint64_t addr, const uint32_t node, const bool alloc)
+{
+    if (Profiling)
+    {
+        MemProfileAccess(addr, node, alloc);
+    }
+
+    if (StreamBatch[node] && NodeMode[node] == MEM_NODE_HEAP)
+    {
+        DetectStream(addr, node, alloc);
+    }
+
+    return LookupPage(addr, node, alloc);
+}
+
+// -------------------------------------------------------------------------
+// GetWritePage()
+//
+// Returns a pointer to the 4K page containing addr, for writing len
+// bytes from addr (within the page), allocating the page if needed.
+//
+// -------------------------------------------------------------------------
+
+static char* GetWritePage(const uint64_t addr, const uint32_t node, const uint64_t len)
+{
+    char* page = GetPage(addr, node, true);
+
+    // Only once allocated, so a failed write leaves nothing dirty
+    if (page != NULL && DirtyTracking[node])
+    {
+        MarkDirty(node, addr, len);
+    }
+
+    return page;
+}
+
+// -------------------------------------------------------------------------
+// ReleaseNodePages()
+//
+// Drop a heap backed node's references to its pages, and free its
+// page tables, leaving the node empty.
+//
+// -------------------------------------------------------------------------
+
+static void ReleaseNodePages(const uint32_t node)
+{
+    pPrimaryHash_t pt = &PrimaryTable[node];
+    uint32_t i, sidx;
+
+    for (i = 0; i < pt->size; i++)
+    {
+        if (pt->tbl[i].valid && pt->tbl[i].p != NULL)
+        {
+            for (sidx = 0; sidx < TABLESIZE; sidx++)
+            {
+                if (pt->tbl[i].p[sidx] != NULL)
+                {
+                    FreeMemPage(pt->tbl[i].p[sidx]);
+                }
+            }
+            free(pt->tbl[i].p);
+        }
+    }
+
+    free(pt->tbl);
+
+    InitialiseMem(node);
+}
+
+// -------------------------------------------------------------------------
+// SetMemUninitCheck()
+//
+// Turn on or off maintaining shadow state of a node's defined bytes
+//
+// -------------------------------------------------------------------------
+
+void SetMemUninitCheck (const uint32_t node, const bool enable)
+{
+    SyncMemWriteBehind();
+
+    UninitCheck[node] = enable;
+}
+
+// -------------------------------------------------------------------------
+// MemCloneNode()
+//
+// Make heap backed node dst a copy of heap backed node src, replacing
+// any existing contents and generators of dst. Only the page tables,
+// and the list of generators, are copied, with
+// the pages themselves shared between the two nodes until written by
+// either, when the writing node is given its own copy of the page.
+// When dirty tracking is on for dst, all of the cloned pages are
+// marked dirty, and when uninitialised read checking is on for dst,
+// its shadow state is replaced with that of the cloned pages. On
+// failure, dst is left with no pages.
+//
+// -------------------------------------------------------------------------
+
+int MemCloneNode(const uint32_t src, const uint32_t dst)
+{
+    pPrimaryHash_t sp = &PrimaryTable[src];
+    pPrimaryHash_t dp = &PrimaryTable[dst];
+    uint64_t page_addr;
+    uint32_t i, sidx;
+
+    if (src == dst || NodeMode[src] != MEM_NODE_HEAP || NodeMode[dst] != MEM_NODE_HEAP)
+    {
+        printf("MemCloneNode: ***Error --- can only clone between two different heap backed nodes\n");
+        return MEM_BAD_STATUS;
+    }
+
+    // The source's page tables must be complete, and dst's not being written
+    SyncMemWriteBehind();
+
+    ReleaseNodePages(dst);
+    CloneMemGenerators(src, dst);
+
+    if (UninitCheck[dst])
+    {
+        ClearUninitShadow(dst);
+    }
+
+    if (sp->tbl == NULL)
+    {
+        return MEM_GOOD_STATUS;
+    }
+
+    if ((dp->tbl = calloc(sp->size, sizeof(PrimaryTbl_t))) == NULL)
+    {
+        printf("MemCloneNode: ***Error --- failed to allocate primary table memory\n");
+        return MEM_BAD_STATUS;
+    }
+
+    dp->size = sp->size;
+
+    for (i = 0; i < sp->size; i++)
+    {
+        if (!sp->tbl[i].valid)
+        {
+            continue;
+        }
+
+        dp->tbl[i]   = sp->tbl[i];
+        dp->tbl[i].p = NULL;
+        dp->used++;
+
+        if (sp->tbl[i].p == NULL)
+        {
+            continue;
+        }
+
+        // On failure, leave dst empty rather than partly cloned
+        if ((dp->tbl[i].p = malloc(TABLESIZE * sizeof(pMemPage_t))) == NULL)
+        {
+            printf("MemCloneNode: ***Error --- failed to allocate secondary table memory\n");
+            ReleaseNodePages(dst);
+
+            if (UninitCheck[dst])
+            {
+                ClearUninitShadow(dst);
+            }
+            return MEM_BAD_STATUS;
+        }
+
+        memcpy(dp->tbl[i].p, sp->tbl[i].p, TABLESIZE * sizeof(pMemPage_t));
+
+        for (sidx = 0; sidx < TABLESIZE; sidx++)
+        {
+            if (dp->tbl[i].p[sidx] != NULL)
+            {
+                page_addr = dp->tbl[i].addr | ((uint64_t)sidx * TABLESIZE);
+
+                dp->tbl[i].p[sidx]->refs++;
+
+                // Every cloned page differs from what dst held before
+                if (DirtyTracking[dst])
+                {
+                    MarkDirty(dst, page_addr, TABLESIZE);
+                }
+
+                if (UninitCheck[dst])
+                {
+                    MemCopyDefined(dst, page_addr, src, page_addr, TABLESIZE);
+                }
+            }
+        }
+    }
+
+    return MEM_GOOD_STATUS;
+}
+
+#if !defined(_WIN32)
+
+// -------------------------------------------------------------------------
+// CreateFlatMem()
+//
+// Make node a flat node, covering size bytes from addr, backed by a
+// single anonymous mapping with no swap reserved. The host OS only
+// commits memory for pages as they are touched, so address
+// translation is just an offset from the mapping's base. Memory in
+// a flat node always starts as zeros.
+//
+// -------------------------------------------------------------------------
+
+int CreateFlatMem (const uint32_t node, const uint64_t addr, const uint64_t size)
+{
+    uint64_t map_size = (size + TABLEMASK) & ~TABLEMASK;
+    void* base;
+
+    SyncMemWriteBehind();
+
+    if (NodeMode[node] != MEM_NODE_HEAP || PrimaryTable[node].tbl != NULL)
+    {
+        printf("CreateFlatMem: ***Error --- node %d already in use\n", node);
+        return MEM_BAD_STATUS;
+    }
+
+    if (addr & TABLEMASK)
+    {
+        printf("CreateFlatMem: ***Error --- flat node address 0x%llx not page aligned\n", (long long unsigned)addr);
+        return MEM_BAD_STATUS;
+    }
+
+    base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (base == MAP_FAILED)
+    {
+        printf("CreateFlatMem: ***Error --- failed to reserve 0x%llx bytes for flat node\n", (long long unsigned)map_size);
+        return MEM_BAD_STATUS;
+    }
+
+    FlatBase[node] = (char*)base;
+    FlatAddr[node] = addr;
+    FlatSize[node] = map_size;
+    NodeMode[node] = MEM_NODE_FLAT;
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// DestroyFlatMem()
+//
+// Release a flat node's mapping, returning the node to heap backing
+//
+// -------------------------------------------------------------------------
+
+void DestroyFlatMem (const uint32_t node)
+{
+    SyncMemWriteBehind();
+
+    if (NodeMode[node] != MEM_NODE_FLAT)
+    {
+        return;
+    }
+
+    munmap(FlatBase[node], FlatSize[node]);
+
+    FlatBase[node] = NULL;
+    FlatAddr[node] = 0;
+    FlatSize[node] = 0;
+    NodeMode[node] = MEM_NODE_HEAP;
+}
+
+// -------------------------------------------------------------------------
+// FlatMemResident()
+//
+// Returns the number of bytes of a flat node actually resident in
+// host memory.
+//
+// -------------------------------------------------------------------------
+
+uint64_t FlatMemResident (const uint32_t node)
+{
+    uint64_t host_page, num_host_pages, idx, resident = 0;
+    unsigned char* vec;
+
+    WaitMemWriteBehind();
+
+    if (NodeMode[node] != MEM_NODE_FLAT)
+    {
+        return 0;
+    }
+
+    host_page      = (uint64_t)sysconf(_SC_PAGESIZE);
+    num_host_pages = (FlatSize[node] + host_page - 1) / host_page;
+
+    if ((vec = malloc(num_host_pages)) == NULL)
+    {
+        printf("FlatMemResident: ***Error --- failed to allocate memory\n");
+        return 0;
+    }
+
+    if (mincore(FlatBase[node], FlatSize[node], vec) == 0)
+    {
+        for (idx = 0; idx < num_host_pages; idx++)
+        {
+            resident += vec[idx] & 1;
+        }
+    }
+
+    free(vec);
+
+    return resident * host_page;
+}
+
+#else
+
+// -------------------------------------------------------------------------
+// Flat nodes are not supported on Windows builds
+// -------------------------------------------------------------------------
+
+int CreateFlatMem (const uint32_t node, const uint64_t addr, const uint64_t size)
+{
+    printf("CreateFlatMem: ***Error --- flat nodes not supported on this platform\n");
+    return MEM_BAD_STATUS;
+}
+
+void DestroyFlatMem (const uint32_t node)
+{
+}
+
+uint64_t FlatMemResident (const uint32_t node)
+{
+    return 0;
+}
+
+#endif
+
+// -------------------------------------------------------------------------
+// SetDefinedBytes()
+//
+// Mark the bytes of a block write enabled by fbe and lbe as defined,
+// a run of contiguous bytes at a time
+//
+// -------------------------------------------------------------------------
+
+static void SetDefinedBytes(const uint64_t addr, const int fbe, const int lbe, const int length, const uint32_t node)
+{
+    int idx, start = -1;
+
+    for (idx = 0; idx <= length; idx++)
+    {
+        if (idx < length && ((idx < 4 && ((1<<idx) & fbe)) ||
+                             (idx >= (length-4) && ((1<<(4-(length-idx))) & lbe)) ||
+                             (idx >= 4 && idx < (length-4))))
+        {
+            start = (start < 0) ? idx : start;
+        }
+        else if (start >= 0)
+        {
+            MarkDefined(node, addr + start, idx - start);
+            start = -1;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// WriteRamByteBlock()
+//
+// Write a block of data to memory
+//
+// -------------------------------------------------------------------------
+
+void WriteRamByteBlock(const uint64_t addr, const PktData_t *data, const int fbe, int const lbe, const int length, const uint32_t node)
+{
+    uint32_t offset;
+    char* page;
+    int idx;
+
+    offset = addr & TABLEMASK;
+
+    if ((addr & ~TABLEMASK) != ((addr + length - 1) & ~TABLEMASK))
+    {
+        printf("WriteRamByteBlock: ***Error --- block write crosses 4K boundary (addr=0x%llx len=0x%x\n", (long long unsigned)addr, length);
+    }
+
+    if ((page = GetWritePage(addr, node, length)) == NULL)
+    {
+        return;
+    }
+
+    for (idx = 0; idx < length; idx++)
+    {
+        if ( (idx < 4 && ((1<<idx) & fbe)) ||
+             (idx >= (length-4) && ((1<<(4-(length-idx))) & lbe)) ||
+             (idx >= 4 && idx < (length-4)))
+        {
+            page[idx+offset] = data[idx];
+        }
+    }
+
+    if (UninitCheck[node])
+    {
+        SetDefinedBytes(addr, fbe, lbe, length, node);
+    }
+}
+
+// -------------------------------------------------------------------------
+// ReadRamBlock()
+//
+// Read a block of data from memory, without checking whether it
+// is defined.
+//
+// -------------------------------------------------------------------------
+
+static int ReadRamBlock(const uint64_t addr, PktData_t *data, const int length, const uint32_t node)
+{
+    uint32_t offset;
+    char* page;
+    int idx;
+
+    offset = addr & TABLEMASK;
+
+    if ((addr & ~TABLEMASK) != ((addr + length-1) & ~TABLEMASK))
+    {
+        printf("ReadRamBlock: ***Error --- block read crosses 4K boundary\n");
+    }
+
+    if ((page = GetPage(addr, node, false)) == NULL)
+    {
+        return MEM_BAD_STATUS;
+    }
+
+    for (idx = 0; idx < length; idx++)
+    {
+        data[idx] = page[idx+offset] & 0xff;
+    }
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// ReadRamByteBlock()
+//
+// Read a block of data from memory.
+//
+// -------------------------------------------------------------------------
+
+int ReadRamByteBlock(const uint64_t addr, PktData_t *data, const int length, const uint32_t node)
+{
+    WaitMemWriteBehind();
+
+    if (UninitCheck[node])
+    {
+        MemCheckDefined(node, addr, length);
+    }
+
+    return ReadRamBlock(addr, data, length, node);
+}
+
+// -------------------------------------------------------------------------
+// WriteRamByte()
+//
+// Write a data byte to memory.
+//
+// -------------------------------------------------------------------------
+
+void WriteRamByte(const uint64_t inaddr, const uint32_t data, const uint32_t node)
+{
+    uint64_t addr;
+    int addr_lo, fbe;
+    PktData_t buf[4];
+
+    SyncMemWriteBehind();
+
+    addr = inaddr & ~3ULL;
+    addr_lo = (int)(inaddr & 3ULL);
+    fbe  = 0x1 << addr_lo;
+    buf[addr_lo] = data & 0xff;
+
+    WriteRamByteBlock (addr, buf, fbe, 0, 4, node);
+}
+
+// -------------------------------------------------------------------------
+// WriteRamHWord()
+//
+// Write a data half word to memory.
+//
+// -------------------------------------------------------------------------
+
+void WriteRamHWord (const uint64_t addr, const uint32_t data, const int le, const uint32_t node)
+{
+    uint32_t data_out;
+    int addr_lo, fbe;
+    PktData_t buf[4];
+    int i;
+
+    SyncMemWriteBehind();
+
+    addr_lo  =  (int)(addr & 2ULL);
+    fbe      = 0x3 << addr_lo;
+    data_out = (addr_lo) ? (data << 16) : data;
+
+    for (i = 0; i < 4; i++)
+    {
+        buf[i] = (le ? (data_out >> (i*8))  & 0xffffUL: (data_out >> ((3-i)*8))) & 0xff;
+    }
+
+    WriteRamByteBlock (addr & ~3ULL, buf, fbe, 0x0, 4, node);
+}
+
+// -------------------------------------------------------------------------
+// WriteRamWord()
+//
+// Write a data word to memory.
+//
+// -------------------------------------------------------------------------
+
+void WriteRamWord (const uint64_t addr, const uint32_t data, const int le, const uint32_t node)
+{
+    PktData_t buf[4];
+    int i;
+
+    SyncMemWriteBehind();
+
+    for (i = 0; i < 4; i++)
+    {
+        buf[i] = (le ? (data >> (i*8)) : (data >> ((3-i)*8))) & 0xff;
+    }
+
+    WriteRamByteBlock (addr & ~3ULL, buf, 0xf, 0x0, 4, node);
+}
+
+// -------------------------------------------------------------------------
+// WriteRamDWord()
+//
+// Write a double data word (64 bits) to memory.
+//
+// -------------------------------------------------------------------------
+
+void WriteRamDWord (const uint64_t addr, const uint64_t data, const int le, const uint32_t node)
+{
+    PktData_t buf[8];
+    int i;
+
+    SyncMemWriteBehind();
+
+    for (i = 0; i < 8; i++)
+    {
+        buf[i] = (PktData_t) (le ? (data >> (i*8)) : (data >> ((7-i)*8))) & 0xffULL;
+    }
+
+    WriteRamByteBlock (addr & ~7ULL, buf, 0xf, 0xf, 8, node);
+}
+
+// -------------------------------------------------------------------------
+// ReadRamByte()
+//
+// Read a byte from memory
+//
+// -------------------------------------------------------------------------
+
+uint32_t ReadRamByte (const uint64_t addr, const uint32_t node)
+{
+    PktData_t buf[4];
+    int i;
+
+    WaitMemWriteBehind();
+
+    if (UninitCheck[node])
+    {
+        MemCheckDefined(node, addr, 1);
+    }
+
+    // If ReadRamBlock fails, return 0
+    if (ReadRamBlock (addr & ~3ULL, buf, 4, node))
+    {
+        return 0;
+    }
+
+    i = (int)(addr & 3ULL);
+
+    return buf[i];
+}
+
+// -------------------------------------------------------------------------
+// ReadRamHWord()
+//
+// Read a half word from memory
+//
+// -------------------------------------------------------------------------
+
+uint32_t ReadRamHWord (const uint64_t addr, const int le, const uint32_t node)
+{
+    PktData_t buf[4];
+    uint32_t data = 0;
+    int addr_lo = addr & 0x2;
+    int i;
+
+    WaitMemWriteBehind();
+
+    if (UninitCheck[node])
+    {
+        MemCheckDefined(node, addr & ~1ULL, 2);
+    }
+
+    // If ReadRamBlock fails, return 0
+    if (ReadRamBlock (addr & ~3ULL, buf, 4, node))
+    {
+        return 0;
+    }
+
+    for (i = addr_lo; i < (2+addr_lo); i++)
+    {
+        data |= (buf[i] & 0xff) << (le ? (i*8) : ((3-i)*8));
+    }
+
+    return (addr_lo) ? (data >> 16) : data;
+}
+
+// -------------------------------------------------------------------------
+// ReadRamWord()
+//
+// Read a word from memory
+//
+// -------------------------------------------------------------------------
+
+uint32_t ReadRamWord (const uint64_t addr, const int le, const uint32_t node)
+{
+    PktData_t buf[4];
+    uint32_t data = 0;
+    int i;
+
+    WaitMemWriteBehind();
+
+    if (UninitCheck[node])
+    {
+        MemCheckDefined(node, addr & ~3ULL, 4);
+    }
+
+    // If ReadRamBlock fails, return 0
+    if (ReadRamBlock (addr & ~3ULL, buf, 4, node))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        data |= (buf[i] & 0xff) << (le ? (i*8) : ((3-i)*8));
+    }
+
+    return data;
+}
+
+// -------------------------------------------------------------------------
+// ReadRamDWord()
+//
+// Read a double word (64 bits) from memory
+//
+// -------------------------------------------------------------------------
+
+uint64_t ReadRamDWord (const uint64_t addr, const int le, const uint32_t node)
+
+{
+    PktData_t buf[8];
+    uint64_t data = 0;
+    int i;
+
+    WaitMemWriteBehind();
+
+    if (UninitCheck[node])
+    {
+        MemCheckDefined(node, addr & ~7ULL, 8);
+    }
+
+    // If ReadRamBlock fails, return 0
+    if (ReadRamBlock (addr & ~7ULL, buf, 8, node))
+    {
+        return 0ULL;
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        data |= ((uint64_t)(buf[i] & 0xff)) << (le ? (i*8) : ((7-i)*8));
+    }
+
+    return data;
+}
+
+// -------------------------------------------------------------------------
+// ReadPageChunk()
+//
+// Returns a pointer to the memory at addr, and the number of bytes (up
+// to len) before the end of its page. Unallocated pages return a
+// pointer to a page of zeros, matching the value returned by reads.
+//
+// -------------------------------------------------------------------------
+
+static const char* ReadPageChunk(const uint64_t addr, const uint64_t len, const uint32_t node, uint64_t* chunk)
+{
+    const char* page;
+    uint32_t offset = addr & TABLEMASK;
+
+    *chunk = (len < (TABLESIZE - offset)) ? len : (TABLESIZE - offset);
+
+    if (UninitCheck[node])
+    {
+        MemCheckDefined(node, addr, *chunk);
+    }
+
+    if ((page = GetPage(addr, node, false)) == NULL)
+    {
+        page = ZeroPage;
+    }
+
+    return page + offset;
+}
+
+// -------------------------------------------------------------------------
+// FirstMismatch()
+//
+// Returns the offset of the first differing byte in two buffers of len
+// bytes, or -1 if they match. The (vectorised) library memcmp is used
+// to check the whole buffer before searching for the byte.
+//
+// -------------------------------------------------------------------------
+
+static int64_t FirstMismatch(const char* a, const char* b, const uint64_t len)
+{
+    uint64_t idx;
+
+    if (memcmp(a, b, len) == 0)
+    {
+        return MEM_COMPARE_MATCH;
+    }
+
+    for (idx = 0; a[idx] == b[idx]; idx++)
+        ;
+
+    return (int64_t)idx;
+}
+
+// -------------------------------------------------------------------------
+// MemCompare()
+//
+// Compare len bytes of memory at addr with a buffer, working a page at a
+// time. Returns the offset of the first mismatching byte, or
+// MEM_COMPARE_MATCH (-1) if the whole range matches.
+//
+// -------------------------------------------------------------------------
+
+int64_t MemCompare(const uint32_t node, const uint64_t addr, const void* expected, const uint64_t len)
+{
+    const char* exp = (const char*)expected;
+    const char* mem;
+    uint64_t    done = 0, chunk;
+    int64_t     diff;
+
+    WaitMemWriteBehind();
+
+    while (done < len)
+    {
+        mem = ReadPageChunk(addr + done, len - done, node, &chunk);
+
+        if ((diff = FirstMismatch(mem, exp + done, chunk)) != MEM_COMPARE_MATCH)
+        {
+            return (int64_t)done + diff;
+        }
+
+        done += chunk;
+    }
+
+    return MEM_COMPARE_MATCH;
+}
+
+// -------------------------------------------------------------------------
+// MemCompareNodes()
+//
+// Compare len bytes of memory at addr_a in node_a with that at addr_b in
+// node_b. Returns the offset of the first mismatching byte, or
+// MEM_COMPARE_MATCH (-1) if the whole range matches.
+//
+// -------------------------------------------------------------------------
+
+int64_t MemCompareNodes(const uint32_t node_a, const uint64_t addr_a, const uint32_t node_b, const uint64_t addr_b, const uint64_t len)
+{
+    const char* mem_a;
+    const char* mem_b;
+    uint64_t    done = 0, chunk, chunk_b;
+    int64_t     diff;
+
+    WaitMemWriteBehind();
+
+    while (done < len)
+    {
+        mem_a = ReadPageChunk(addr_a + done, len - done, node_a, &chunk);
+        mem_b = ReadPageChunk(addr_b + done, chunk,      node_b, &chunk_b);
+
+        if ((diff = FirstMismatch(mem_a, mem_b, chunk_b)) != MEM_COMPARE_MATCH)
+        {
+            return (int64_t)done + diff;
+        }
+
+        done += chunk_b;
+    }
+
+    return MEM_COMPARE_MATCH;
+}
+
+// -------------------------------------------------------------------------
+// Crc32cBlock()
+//
+// Update a CRC32C (Castagnoli) over a buffer, using the SSE4.2 CRC
+// instructions when compiled for them, else a table driven calculation.
+//
+// -------------------------------------------------------------------------
+
+static uint32_t Crc32cBlock(uint32_t crc, const char* buf, uint64_t len)
+{
+#if defined(__SSE4_2__)
+    uint64_t crc64 = crc;
+    uint64_t word;
+
+    while (len >= 8)
+    {
+        memcpy(&word, buf, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        buf  += 8;
+        len  -= 8;
+    }
+
+    crc = (uint32_t)crc64;
+
+    while (len--)
+    {
+        crc = _mm_crc32_u8(crc, (uint8_t)*buf++);
+    }
+#else
+    int i, j;
+    uint32_t c;
+
+    if (Crc32cTable[1] == 0)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            c = i;
+            for (j = 0; j < 8; j++)
+            {
+                c = (c & 1) ? ((c >> 1) ^ 0x82f63b78UL) : (c >> 1);
+            }
+            Crc32cTable[i] = c;
+        }
+    }
+
+    while (len--)
+    {
+        crc = Crc32cTable[(crc ^ (uint8_t)*buf++) & 0xff] ^ (crc >> 8);
+    }
+#endif
+
+    return crc;
+}
+
+// -------------------------------------------------------------------------
+// MemCrc32c()
+//
+// Calculate the CRC32C of len bytes of memory at addr, with unallocated
+// memory read as zeros. The result matches a standard CRC32C (initial
+// value and final XOR of 0xffffffff) of the same data.
+//
+// -------------------------------------------------------------------------
+
+uint32_t MemCrc32c(const uint32_t node, const uint64_t addr, const uint64_t len)
+{
+    const char* mem;
+    uint64_t    done = 0, chunk;
+    uint32_t    crc = 0xffffffffUL;
+
+    WaitMemWriteBehind();
+
+    while (done < len)
+    {
+        mem   = ReadPageChunk(addr + done, len - done, node, &chunk);
+        crc   = Crc32cBlock(crc, mem, chunk);
+        done += chunk;
+    }
+
+    return crc ^ 0xffffffffUL;
+}
+
+// -------------------------------------------------------------------------
+// SkipZeroFill()
+//
+// Returns true if a zero fill of an unallocated page can be skipped.
+// Unallocated pages read as zero but, unless new pages are zeroed when
+// allocated, a later partial write would expose uninitialised data
+// in the rest of the page, so the page must then be allocated.
+//
+// -------------------------------------------------------------------------
+
+static bool SkipZeroFill(const uint64_t addr, const uint32_t node)
+{
+#ifdef MEM_ZERO_NEW_PAGES
+    return GetPage(addr, node, false) == NULL;
+#else
+    return false;
+#endif
+}
+
+// -------------------------------------------------------------------------
+// MemFill()
+//
+// Fill len bytes of memory from addr with a repeated 32 bit pattern.
+// The pattern is aligned to 32 bit word addresses, with the byte order
+// set by little_endian, as for WriteRamWord(). Work is done a page at a
+// time, and zero fills of unallocated pages are skipped where allowed.
+//
+// -------------------------------------------------------------------------
+
+void MemFill(const uint32_t node, const uint64_t addr, const uint32_t pattern, const uint64_t len, const int little_endian)
+{
+    static char pat_page[TABLESIZE];
+    static char pat_bytes[4];
+    static bool pat_valid = false;
+
+    uint64_t done = 0, chunk;
+    uint32_t offset;
+    char     bytes[4];
+    bool     uniform;
+    char*    page;
+    int      i;
+
+    SyncMemWriteBehind();
+
+    for (i = 0; i < 4; i++)
+    {
+        bytes[i] = (char)((little_endian ? (pattern >> (i*8)) : (pattern >> ((3-i)*8))) & 0xff);
+    }
+
+    uniform = bytes[0] == bytes[1] && bytes[0] == bytes[2] && bytes[0] == bytes[3];
+
+    if (UninitCheck[node])
+    {
+        MarkDefined(node, addr, len);
+    }
+
+    // For non-uniform patterns, build a whole page of the pattern to copy from
+    if (!uniform && (!pat_valid || memcmp(pat_bytes, bytes, 4) != 0))
+    {
+        for (i = 0; i < TABLESIZE; i++)
+        {
+            pat_page[i] = bytes[i & 3];
+        }
+        memcpy(pat_bytes, bytes, 4);
+        pat_valid = true;
+    }
+
+    while (done < len)
+    {
+        offset = (addr + done) & TABLEMASK;
+        chunk  = ((len - done) < (TABLESIZE - offset)) ? (len - done) : (TABLESIZE - offset);
+
+        if (!(uniform && bytes[0] == 0 && SkipZeroFill(addr + done, node)))
+        {
+            if ((page = GetWritePage(addr + done, node, chunk)) == NULL)
+            {
+                return;
+            }
+
+            if (uniform)
+            {
+                memset(page + offset, bytes[0], chunk);
+            }
+            else
+            {
+                memcpy(page + offset, pat_page + offset, chunk);
+            }
+        }
+
+        done += chunk;
+    }
+}
+
+// -------------------------------------------------------------------------
+// CopyChunk()
+//
+// Copy a chunk of memory that lies within a single page of both source
+// and destination. Unallocated source memory is copied as zeros.
+//
+// -------------------------------------------------------------------------
+
+static void CopyChunk(const uint32_t dst_node, const uint64_t dst, const uint32_t src_node, const uint64_t src, const uint64_t chunk)
+{
+    char* src_page;
+    char* dst_page;
+
+    // Copy the source's defined state, before the source may be overwritten
+    if (UninitCheck[dst_node])
+    {
+        MemCopyDefined(dst_node, dst, src_node, src, chunk);
+    }
+
+    if ((src_page = GetPage(src, src_node, false)) == NULL)
+    {
+        if (!SkipZeroFill(dst, dst_node) && (dst_page = GetWritePage(dst, dst_node, chunk)) != NULL)
+        {
+            memset(dst_page + (dst & TABLEMASK), 0, chunk);
+        }
+        return;
+    }
+
+    if ((dst_page = GetWritePage(dst, dst_node, chunk)) != NULL)
+    {
+        memmove(dst_page + (dst & TABLEMASK), src_page + (src & TABLEMASK), chunk);
+    }
+}
+
+// -------------------------------------------------------------------------
+// MemCopy()
+//
+// Copy len bytes of memory from src in src_node to dst in dst_node, a
+// page at a time. Overlapping ranges in the same node are copied as if
+// through an intermediate buffer (i.e. as for memmove).
+//
+// -------------------------------------------------------------------------
+
+void MemCopy(const uint32_t dst_node, const uint64_t dst, const uint32_t src_node, const uint64_t src, const uint64_t len)
+{
+    uint64_t done = 0, chunk, src_space, dst_space;
+
+    SyncMemWriteBehind();
+
+    if (len == 0 || (dst_node == src_node && dst == src))
+    {
+        return;
+    }
+
+    // If the destination overlaps the end of the source, copy from the end backwards
+    if (dst_node == src_node && dst > src && dst < src + len)
+    {
+        while (done < len)
+        {
+            src_space = ((src + len - done - 1) & TABLEMASK) + 1;
+            dst_space = ((dst + len - done - 1) & TABLEMASK) + 1;
+            chunk     = len - done;
+            chunk     = (chunk < src_space) ? chunk : src_space;
+            chunk     = (chunk < dst_space) ? chunk : dst_space;
+
+            done     += chunk;
+
+            CopyChunk(dst_node, dst + len - done, src_node, src + len - done, chunk);
+        }
+    }
+    else
+    {
+        while (done < len)
+        {
+            src_space = TABLESIZE - ((src + done) & TABLEMASK);
+            dst_space = TABLESIZE - ((dst + done) & TABLEMASK);
+            chunk     = len - done;
+            chunk     = (chunk < src_space) ? chunk : src_space;
+            chunk     = (chunk < dst_space) ? chunk : dst_space;
+
+            CopyChunk(dst_node, dst + done, src_node, src + done, chunk);
+
+            done     += chunk;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// MemReadBlock()
+//
+// Read len bytes of memory from addr into buf. Unallocated memory
+// reads as zero.
+//
+// -------------------------------------------------------------------------
+
+void MemReadBlock(const uint32_t node, const uint64_t addr, void* buf, const uint64_t len)
+{
+    uint64_t    done = 0, chunk;
+    const char* src;
+
+    WaitMemWriteBehind();
+
+    while (done < len)
+    {
+        src = ReadPageChunk(addr + done, len - done, node, &chunk);
+        memcpy((char*)buf + done, src, chunk);
+        done += chunk;
+    }
+}
+
+// -------------------------------------------------------------------------
+// MemPeekBlock()
+//
+// Read len bytes from memory at addr into buf, as for MemReadBlock(),
+// but without checking for uninitialised reads, or counting towards
+// profiling or stream detection. For the model's own inspection of
+// memory, such as delta dumps.
+//
+// -------------------------------------------------------------------------
+
+void MemPeekBlock(const uint32_t node, const uint64_t addr, void* buf, const uint64_t len)
+{
+    uint64_t    done = 0, chunk;
+    uint32_t    offset;
+    const char* page;
+
+    WaitMemWriteBehind();
+
+    while (done < len)
+    {
+        offset = (addr + done) & TABLEMASK;
+        chunk  = ((len - done) < (TABLESIZE - offset)) ? (len - done) : (TABLESIZE - offset);
+
+        if ((page = LookupPage(addr + done, node, false)) == NULL)
+        {
+            page = ZeroPage;
+        }
+
+        memcpy((char*)buf + done, page + offset, chunk);
+        done += chunk;
+    }
+}
+
+// -------------------------------------------------------------------------
+// MemWriteBlock()
+//
+// Write len bytes from buf to memory at addr
+//
+// -------------------------------------------------------------------------
+
+void MemWriteBlock(const uint32_t node, const uint64_t addr, const void* buf, const uint64_t len)
+{
+    uint64_t done = 0, chunk;
+    uint32_t offset;
+    char*    page;
+
+    SyncMemWriteBehind();
+
+    if (UninitCheck[node])
+    {
+        MarkDefined(node, addr, len);
+    }
+
+    while (done < len)
+    {
+        offset = (addr + done) & TABLEMASK;
+        chunk  = ((len - done) < (TABLESIZE - offset)) ? (len - done) : (TABLESIZE - offset);
+
+        if ((page = GetWritePage(addr + done, node, chunk)) == NULL)
+        {
+            return;
+        }
+
+        memcpy(page + offset, (const char*)buf + done, chunk);
+        done += chunk;
+    }
+}
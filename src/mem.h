@@ -18,6 +18,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "mem_page.h"
+#include "mem_hash.h"
+
 // -------------------------------------------------------------------------
 // DEFINES
 // -------------------------------------------------------------------------
@@ -29,13 +32,33 @@
 #define TABLESIZE      (4096UL)
 #define TABLEMASK      (TABLESIZE-1)
 
+// Primary table of 16MB regions, grown as needed
+#define PRIMARY_REGION_BITS 24
+#define PRIMARY_REGION_MASK (~((1ULL << PRIMARY_REGION_BITS) - 1))
+#define PRIMARY_INIT_SIZE   (1024UL)
+#define PRIMARY_MAX_SIZE    (1UL << 30)
+#define PRIMARY_MAX_PROBE   16
+
+// Page keyed side tables (dirty pages, shadow bitmaps), grown as needed
+#define PAGE_TABLE_INIT_SIZE (1024UL)
+
 #define MEM_BAD_STATUS  1
 #define MEM_GOOD_STATUS 0
 
+#define MEM_COMPARE_MATCH (-1)
+
+// Consecutive ascending page accesses before a node's accesses are treated as a stream
+#define MEM_STREAM_MIN_RUN  2
+
 #ifndef VP_MAX_NODES
 #define VP_MAX_NODES 64
 #endif
 
+// Node page store backing modes
+#define MEM_NODE_HEAP   0
+#define MEM_NODE_SHM    1
+#define MEM_NODE_FLAT   2
+
 #ifdef DEBUG
 # ifndef Debugprintf
 # define Debugprintf printf
@@ -49,19 +72,65 @@
 // -------------------------------------------------------------------------
 
 typedef struct {
-    char** p;
+    pMemPage_t* p;
     uint64_t addr;
     bool   valid;
 } PrimaryTbl_t, *pPrimaryTbl_t;
 
+typedef struct {
+    pPrimaryTbl_t tbl;
+    uint32_t      size;
+    uint32_t      used;
+} PrimaryHash_t, *pPrimaryHash_t;
+
+// Entry of a page keyed table, with a val of 0 marking an unused entry
+typedef struct {
+    uint64_t addr;
+    uint64_t val;
+} PageEntry_t, *pPageEntry_t;
+
+typedef struct {
+    pPageEntry_t tbl;
+    uint64_t     size;
+    uint64_t     used;
+    pPageEntry_t last;              // Last entry found or added
+} PageTable_t, *pPageTable_t;
+
 typedef uint16_t  PktData_t;
 typedef uint16_t* pPktData_t;
 
+// -------------------------------------------------------------------------
+// INLINE FUNCTIONS
+// -------------------------------------------------------------------------
+
+// Hint to the CPU that this is a spin wait loop
+static inline void MemCpuRelax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
 // -------------------------------------------------------------------------
 // PROTOTYPES
 // -------------------------------------------------------------------------
 
 extern void     InitialiseMem       (int node);
+extern void     SetNodeMode         (const uint32_t node, const int mode);
+extern int      GetNodeMode         (const uint32_t node);
+extern void     SetMemProfiling     (const bool enable);
+extern void     SetMemDirtyTracking (const uint32_t node, const bool enable);
+extern void     SetMemUninitCheck   (const uint32_t node, const bool enable);
+extern void     SetMemStream        (const uint32_t node, const uint32_t batch);
+extern int      MemCloneNode        (const uint32_t src, const uint32_t dst);
+extern int      CreateFlatMem       (const uint32_t node, const uint64_t addr, const uint64_t size);
+extern void     DestroyFlatMem      (const uint32_t node);
+extern uint64_t FlatMemResident     (const uint32_t node);
+
+extern pPageEntry_t FindPageEntry   (const pPageTable_t pt, const uint64_t page_addr);
+extern pPageEntry_t AddPageEntry    (const pPageTable_t pt, const uint64_t page_addr, const uint64_t val);
+extern void     ClearPageTable      (const pPageTable_t pt);
+extern void     FreePageTable       (const pPageTable_t pt);
 
 extern void     WriteRamByteBlock   (const uint64_t addr, const PktData_t* const data, const int fbe, const int lbe, const int length, const uint32_t node);
 extern int      ReadRamByteBlock    (const uint64_t addr, PktData_t* const data, const int length, const uint32_t node);
@@ -73,4 +142,13 @@ extern uint32_t ReadRamByte         (const uint64_t addr, const uint32_t node);
 extern uint32_t ReadRamHWord        (const uint64_t addr, const int little_endian, const uint32_t node);
 extern uint32_t ReadRamWord         (const uint64_t addr, const int little_endian, const uint32_t node);
 extern uint64_t ReadRamDWord        (const uint64_t addr, const int little_endian, const uint32_t node);
+
+extern int64_t  MemCompare          (const uint32_t node, const uint64_t addr, const void* expected, const uint64_t len);
+extern int64_t  MemCompareNodes     (const uint32_t node_a, const uint64_t addr_a, const uint32_t node_b, const uint64_t addr_b, const uint64_t len);
+extern uint32_t MemCrc32c           (const uint32_t node, const uint64_t addr, const uint64_t len);
+extern void     MemFill             (const uint32_t node, const uint64_t addr, const uint32_t pattern, const uint64_t len, const int little_endian);
+extern void     MemCopy             (const uint32_t dst_node, const uint64_t dst, const uint32_t src_node, const uint64_t src, const uint64_t len);
+extern void     MemReadBlock        (const uint32_t node, const uint64_t addr, void* buf, const uint64_t len);
+extern void     MemPeekBlock        (const uint32_t node, const uint64_t addr, void* buf, const uint64_t len);
+extern void     MemWriteBlock       (const uint32_t node, const uint64_t addr, const void* buf, const uint64_t len);
 #endif
@@ -0,0 +1,455 @@
+//=====================================================================
+//
+// mem.hpp                                            Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Header only C++ version of the memory model, for C++ co-models and
+// Verilator test benches. The address width, page size and endianness
+// are template parameters, so table geometry is fixed at compile time
+// and read<T>()/write<T>() can be inlined into the caller. Each
+// MemModel object owns its own page store, and is move only. A
+// moved-from object is left empty, and may still be used.
+//
+// Methods matching the C API in mem.h (less the node and endian
+// arguments) are also provided, so that code written against the C API
+// can be moved over to an object with minimal change.
+//
+// Requires C++14.
+//
+//=====================================================================
+
+#ifndef _MEM_HPP_
+#define _MEM_HPP_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "mem_hash.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define MEM_HPP_BIG_ENDIAN       0
+#define MEM_HPP_LITTLE_ENDIAN    1
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define MEM_HPP_HOST_ENDIAN      MEM_HPP_BIG_ENDIAN
+#else
+#define MEM_HPP_HOST_ENDIAN      MEM_HPP_LITTLE_ENDIAN
+#endif
+
+// -------------------------------------------------------------------------
+// MemModel class template
+// -------------------------------------------------------------------------
+
+template <unsigned AddrBits = 64, unsigned PageBits = 12, int Endian = MEM_HPP_LITTLE_ENDIAN>
+class MemModel
+{
+    static_assert(AddrBits >= PageBits && AddrBits <= 64, "MemModel: AddrBits must be between PageBits and 64");
+    static_assert(PageBits >= 3 && PageBits <= 24,        "MemModel: PageBits must be between 3 and 24");
+
+public:
+
+    // ---------------------------------------------------------------------
+    // Compile time geometry. A page number is split into a secondary
+    // table index (low bits) and a primary table index (high bits). For
+    // narrow address spaces the primary table is directly indexed, else
+    // it is a hash table that grows as needed.
+    // ---------------------------------------------------------------------
+
+    static constexpr unsigned addr_bits      = AddrBits;
+    static constexpr unsigned page_bits      = PageBits;
+    static constexpr uint64_t page_size      = 1ULL << PageBits;
+    static constexpr uint64_t page_mask      = page_size - 1;
+    static constexpr uint64_t addr_mask      = (AddrBits == 64) ? ~0ULL : ((1ULL << (AddrBits % 64)) - 1);
+
+    static constexpr unsigned pnum_bits      = AddrBits - PageBits;
+    static constexpr unsigned sec_bits       = (pnum_bits < 12) ? pnum_bits : 12;
+    static constexpr unsigned pri_bits       = pnum_bits - sec_bits;
+    static constexpr uint64_t sec_size       = 1ULL << sec_bits;
+    static constexpr uint64_t sec_mask       = sec_size - 1;
+    static constexpr bool     direct_primary = pri_bits <= 16;
+
+    static constexpr int      endian         = Endian;
+
+private:
+
+    typedef std::unique_ptr<uint8_t[]>   Page_t;
+
+    struct Secondary_t
+    {
+        Page_t page[sec_size];
+    };
+
+    typedef std::unique_ptr<Secondary_t> pSecondary_t;
+
+    // Directly indexed primary table
+    class DirectPrimary
+    {
+    public:
+        DirectPrimary() : tbl(new pSecondary_t[1ULL << pri_bits]) {}
+
+        Secondary_t* find(const uint64_t pidx) const
+        {
+            return tbl[pidx].get();
+        }
+
+        Secondary_t* insert(const uint64_t pidx)
+        {
+            if (!tbl[pidx])
+            {
+                tbl[pidx].reset(new Secondary_t());
+            }
+            return tbl[pidx].get();
+        }
+
+    private:
+        std::unique_ptr<pSecondary_t[]> tbl;
+    };
+
+    // Open addressed primary hash table, doubled in size when half full
+    class HashPrimary
+    {
+    public:
+        HashPrimary() : size(0), used(0) { resize(64); }
+
+        Secondary_t* find(const uint64_t pidx) const
+        {
+            for (uint64_t idx = MemHash64(pidx) & (size-1); tbl[idx].sec; idx = (idx+1) & (size-1))
+            {
+                if (tbl[idx].key == pidx)
+                {
+                    return tbl[idx].sec.get();
+                }
+            }
+            return nullptr;
+        }
+
+        Secondary_t* insert(const uint64_t pidx)
+        {
+            Secondary_t* sec = find(pidx);
+
+            if (sec == nullptr)
+            {
+                if (2*(used+1) > size)
+                {
+                    resize(size*2);
+                }
+
+                Entry_t* e = slot(pidx);
+                e->key = pidx;
+                e->sec.reset(new Secondary_t());
+                sec = e->sec.get();
+                used++;
+            }
+            return sec;
+        }
+
+    private:
+        struct Entry_t
+        {
+            uint64_t     key;
+            pSecondary_t sec;
+        };
+
+        Entry_t* slot(const uint64_t pidx)
+        {
+            uint64_t idx = MemHash64(pidx) & (size-1);
+
+            while (tbl[idx].sec)
+            {
+                idx = (idx+1) & (size-1);
+            }
+            return &tbl[idx];
+        }
+
+        void resize(const uint64_t new_size)
+        {
+            std::unique_ptr<Entry_t[]> old(std::move(tbl));
+            uint64_t old_size = size;
+
+            tbl.reset(new Entry_t[new_size]());
+            size = new_size;
+
+            for (uint64_t idx = 0; idx < old_size; idx++)
+            {
+                if (old[idx].sec)
+                {
+                    Entry_t* e = slot(old[idx].key);
+                    e->key = old[idx].key;
+                    e->sec = std::move(old[idx].sec);
+                }
+            }
+        }
+
+        std::unique_ptr<Entry_t[]> tbl;
+        uint64_t                   size;
+        uint64_t                   used;
+    };
+
+    typedef typename std::conditional<direct_primary, DirectPrimary, HashPrimary>::type Primary_t;
+
+public:
+
+    MemModel() : primary(new Primary_t()), last_pnum(~0ULL), last_page(nullptr), pages(0) {}
+
+    MemModel(const MemModel&)            = delete;
+    MemModel& operator=(const MemModel&) = delete;
+
+    MemModel(MemModel&& other) noexcept :
+        primary(std::move(other.primary)), last_pnum(other.last_pnum), last_page(other.last_page), pages(other.pages)
+    {
+        other.last_pnum = ~0ULL;
+        other.last_page = nullptr;
+        other.pages     = 0;
+    }
+
+    MemModel& operator=(MemModel&& other) noexcept
+    {
+        if (this != &other)
+        {
+            primary         = std::move(other.primary);
+            last_pnum       = other.last_pnum;
+            last_page       = other.last_page;
+            pages           = other.pages;
+            other.last_pnum = ~0ULL;
+            other.last_page = nullptr;
+            other.pages     = 0;
+        }
+        return *this;
+    }
+
+    // Number of pages allocated
+    uint64_t num_pages() const { return pages; }
+
+    // ---------------------------------------------------------------------
+    // Inlineable access methods. Reads of unallocated memory return 0.
+    // ---------------------------------------------------------------------
+
+    template <typename T>
+    inline T read(const uint64_t addr)
+    {
+        static_assert(std::is_integral<T>::value && sizeof(T) <= 8, "MemModel::read: T must be an integer type of up to 64 bits");
+
+        const uint64_t a   = addr & addr_mask;
+        const uint64_t off = a & page_mask;
+        T              val = 0;
+
+        if (off + sizeof(T) <= page_size)
+        {
+            const uint8_t* p = get_page(a >> PageBits, false);
+
+            if (p == nullptr)
+            {
+                return 0;
+            }
+            std::memcpy(&val, p + off, sizeof(T));
+            return to_host(val);
+        }
+
+        // Access straddles a page boundary
+        uint8_t buf[sizeof(T)];
+        read_block(a, buf, sizeof(T));
+        std::memcpy(&val, buf, sizeof(T));
+        return to_host(val);
+    }
+
+    template <typename T>
+    inline void write(const uint64_t addr, const T data)
+    {
+        static_assert(std::is_integral<T>::value && sizeof(T) <= 8, "MemModel::write: T must be an integer type of up to 64 bits");
+
+        const uint64_t a   = addr & addr_mask;
+        const uint64_t off = a & page_mask;
+        const T        val = to_host(data);
+
+        if (off + sizeof(T) <= page_size)
+        {
+            std::memcpy(get_page(a >> PageBits, true) + off, &val, sizeof(T));
+            return;
+        }
+
+        uint8_t buf[sizeof(T)];
+        std::memcpy(buf, &val, sizeof(T));
+        write_block(a, buf, sizeof(T));
+    }
+
+    // Read a block of bytes, of any length and alignment. Unallocated bytes read as 0.
+    void read_block(uint64_t addr, uint8_t* buf, uint64_t len)
+    {
+        while (len)
+        {
+            const uint64_t a     = addr & addr_mask;
+            const uint64_t off   = a & page_mask;
+            const uint64_t chunk = (len < page_size - off) ? len : page_size - off;
+            const uint8_t* p     = get_page(a >> PageBits, false);
+
+            if (p == nullptr)
+            {
+                std::memset(buf, 0, chunk);
+            }
+            else
+            {
+                std::memcpy(buf, p + off, chunk);
+            }
+
+            addr += chunk;
+            buf  += chunk;
+            len  -= chunk;
+        }
+    }
+
+    // Write a block of bytes, of any length and alignment
+    void write_block(uint64_t addr, const uint8_t* buf, uint64_t len)
+    {
+        while (len)
+        {
+            const uint64_t a     = addr & addr_mask;
+            const uint64_t off   = a & page_mask;
+            const uint64_t chunk = (len < page_size - off) ? len : page_size - off;
+
+            std::memcpy(get_page(a >> PageBits, true) + off, buf, chunk);
+
+            addr += chunk;
+            buf  += chunk;
+            len  -= chunk;
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // C API equivalents (see mem.h), with node and endianness fixed by
+    // the object and template parameters.
+    // ---------------------------------------------------------------------
+
+    void WriteRamByteBlock(const uint64_t addr, const uint16_t* const data, const int fbe, const int lbe, const int length)
+    {
+        uint8_t* p = get_page((addr & addr_mask) >> PageBits, true) + (addr & page_mask);
+
+        for (int idx = 0; idx < length; idx++)
+        {
+            if ( (idx < 4 && ((1<<idx) & fbe)) ||
+                 (idx >= (length-4) && ((1<<(4-(length-idx))) & lbe)) ||
+                 (idx >= 4 && idx < (length-4)))
+            {
+                p[idx] = (uint8_t)data[idx];
+            }
+        }
+    }
+
+    int ReadRamByteBlock(const uint64_t addr, uint16_t* const data, const int length)
+    {
+        const uint8_t* p = get_page((addr & addr_mask) >> PageBits, false);
+
+        if (p == nullptr)
+        {
+            return 1;
+        }
+
+        p += addr & page_mask;
+
+        for (int idx = 0; idx < length; idx++)
+        {
+            data[idx] = p[idx];
+        }
+
+        return 0;
+    }
+
+    void     WriteRamByte  (const uint64_t addr, const uint32_t data) { write<uint8_t> (addr,          (uint8_t)data);  }
+    void     WriteRamHWord (const uint64_t addr, const uint32_t data) { write<uint16_t>(addr & ~1ULL,  (uint16_t)data); }
+    void     WriteRamWord  (const uint64_t addr, const uint32_t data) { write<uint32_t>(addr & ~3ULL,  data);           }
+    void     WriteRamDWord (const uint64_t addr, const uint64_t data) { write<uint64_t>(addr & ~7ULL,  data);           }
+    uint32_t ReadRamByte   (const uint64_t addr)                      { return read<uint8_t> (addr);                    }
+    uint32_t ReadRamHWord  (const uint64_t addr)                      { return read<uint16_t>(addr & ~1ULL);            }
+    uint32_t ReadRamWord   (const uint64_t addr)                      { return read<uint32_t>(addr & ~3ULL);            }
+    uint64_t ReadRamDWord  (const uint64_t addr)                      { return read<uint64_t>(addr & ~7ULL);            }
+
+private:
+
+    // Byte swap a value if the model's endianness differs from the host's
+    template <typename T>
+    static inline T to_host(const T val)
+    {
+        if (Endian == MEM_HPP_HOST_ENDIAN || sizeof(T) == 1)
+        {
+            return val;
+        }
+
+        typename std::make_unsigned<T>::type u = (typename std::make_unsigned<T>::type)val, r = 0;
+
+        for (unsigned i = 0; i < sizeof(T); i++)
+        {
+            r = (r << 8) | (u & 0xff);
+            u >>= 8;
+        }
+        return (T)r;
+    }
+
+    // Return the page for a page number, from the last used page if the same,
+    // else from the tables, allocating if required.
+    inline uint8_t* get_page(const uint64_t pnum, const bool alloc)
+    {
+        if (pnum == last_pnum)
+        {
+            return last_page;
+        }
+        return lookup(pnum, alloc);
+    }
+
+    uint8_t* lookup(const uint64_t pnum, const bool alloc)
+    {
+        // A moved-from object has no tables until next written
+        if (!primary)
+        {
+            if (!alloc)
+            {
+                return nullptr;
+            }
+            primary.reset(new Primary_t());
+        }
+
+        Secondary_t* sec = alloc ? primary->insert(pnum >> sec_bits) : primary->find(pnum >> sec_bits);
+
+        if (sec == nullptr)
+        {
+            return nullptr;
+        }
+
+        Page_t& page = sec->page[pnum & sec_mask];
+
+        if (!page)
+        {
+            if (!alloc)
+            {
+                return nullptr;
+            }
+#ifdef MEM_ZERO_NEW_PAGES
+            page.reset(new uint8_t[page_size]());
+#else
+            page.reset(new uint8_t[page_size]);
+#endif
+            pages++;
+        }
+
+        last_pnum = pnum;
+        last_page = page.get();
+
+        return last_page;
+    }
+
+    std::unique_ptr<Primary_t> primary;
+    uint64_t                   last_pnum;
+    uint8_t*                   last_page;
+    uint64_t                   pages;
+};
+
+#endif
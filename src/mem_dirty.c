@@ -0,0 +1,333 @@
+//=====================================================================
+//
+// mem_dirty.c                                        Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Dirty page tracking. When enabled for a node, the model's write
+// paths mark the pages (or 64 byte blocks within pages) written
+// since dirty state was last cleared, in a hash table of page
+// addresses per node. The dirty pages can be enumerated, and a delta
+// dump of just the dirty data written, so that periodic checkpoints
+// and comparisons cost in proportion to what changed.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "mem_dirty.h"
+#include "mem_wb.h"
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef struct {
+    int             mode;
+    PageTable_t     pages;          // Dirty pages, with the dirty block mask as value
+} MemDirtyNode_t, *pMemDirtyNode_t;
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static MemDirtyNode_t DirtyNode[VP_MAX_NODES];
+
+// -------------------------------------------------------------------------
+// CompareDirty()
+//
+// Order dirty pages by address
+//
+// -------------------------------------------------------------------------
+
+static int CompareDirty(const void* a, const void* b)
+{
+    uint64_t addr_a = ((const MemDirtyPage_t*)a)->addr;
+    uint64_t addr_b = ((const MemDirtyPage_t*)b)->addr;
+
+    return addr_a < addr_b ? -1 : (addr_a > addr_b ? 1 : 0);
+}
+
+// -------------------------------------------------------------------------
+// SetDirtyTracking()
+//
+// Set dirty tracking for a node to MEM_DIRTY_OFF, MEM_DIRTY_PAGE or
+// MEM_DIRTY_SUBPAGE. Any current dirty state is cleared.
+//
+// -------------------------------------------------------------------------
+
+void SetDirtyTracking(const uint32_t node, const int mode)
+{
+    pMemDirtyNode_t d = &DirtyNode[node];
+
+    SyncMemWriteBehind();
+
+    ClearDirty(node);
+
+    d->mode = mode;
+
+    SetMemDirtyTracking(node, mode != MEM_DIRTY_OFF);
+}
+
+// -------------------------------------------------------------------------
+// MarkDirty()
+//
+// Mark len bytes from addr, all within one page, as dirty. Called by
+// the memory model for every write whilst tracking is enabled.
+//
+// -------------------------------------------------------------------------
+
+void MarkDirty(const uint32_t node, const uint64_t addr, const uint64_t len)
+{
+    pMemDirtyNode_t d         = &DirtyNode[node];
+    uint64_t        page_addr = addr & ~TABLEMASK;
+    pPageEntry_t    entry;
+    uint32_t        first, last;
+    uint64_t        mask;
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    if (d->mode == MEM_DIRTY_SUBPAGE)
+    {
+        first = (addr & TABLEMASK) >> MEM_DIRTY_BLOCK_BITS;
+        last  = ((addr & TABLEMASK) + len - 1) >> MEM_DIRTY_BLOCK_BITS;
+        mask  = (last == 63 ? ~0ULL : ((1ULL << (last + 1)) - 1)) & ~((1ULL << first) - 1);
+    }
+    else
+    {
+        mask  = ~0ULL;
+    }
+
+    // Writes tend to hit the same page repeatedly, which FindPageEntry() checks first
+    if ((entry = FindPageEntry(&d->pages, page_addr)) != NULL)
+    {
+        entry->val |= mask;
+    }
+    else
+    {
+        AddPageEntry(&d->pages, page_addr, mask);
+    }
+}
+
+// -------------------------------------------------------------------------
+// GetDirtyPages()
+//
+// Return the number of dirty pages of a node, and fill pages with up
+// to max of them, in address order
+//
+// -------------------------------------------------------------------------
+
+uint64_t GetDirtyPages(const uint32_t node, MemDirtyPage_t* pages, const uint64_t max)
+{
+    pMemDirtyNode_t d = &DirtyNode[node];
+    pMemDirtyPage_t sorted;
+    uint64_t        idx, count = 0;
+
+    // Queued writes still to mark pages dirty must be applied first
+    SyncMemWriteBehind();
+
+    if (d->pages.used == 0 || pages == NULL || max == 0)
+    {
+        return d->pages.used;
+    }
+
+    if ((sorted = malloc(d->pages.used * sizeof(MemDirtyPage_t))) == NULL)
+    {
+        printf("GetDirtyPages: ***Error --- failed to allocate memory\n");
+        return 0;
+    }
+
+    for (idx = 0; idx < d->pages.size; idx++)
+    {
+        if (d->pages.tbl[idx].val != 0)
+        {
+            sorted[count].addr   = d->pages.tbl[idx].addr;
+            sorted[count++].mask = d->pages.tbl[idx].val;
+        }
+    }
+
+    qsort(sorted, count, sizeof(MemDirtyPage_t), CompareDirty);
+
+    memcpy(pages, sorted, (count < max ? count : max) * sizeof(MemDirtyPage_t));
+
+    free(sorted);
+
+    return count;
+}
+
+// -------------------------------------------------------------------------
+// ClearDirty()
+//
+// Mark all pages of a node as clean
+//
+// -------------------------------------------------------------------------
+
+void ClearDirty(const uint32_t node)
+{
+    SyncMemWriteBehind();
+
+    ClearPageTable(&DirtyNode[node].pages);
+}
+
+// -------------------------------------------------------------------------
+// DumpDelta()
+//
+// Write a delta dump of a node's dirty pages to filename, clearing
+// the dirty state afterwards if clear is set, so that the next dump
+// holds only changes since this one.
+//
+// -------------------------------------------------------------------------
+
+int DumpDelta(const uint32_t node, const char* filename, const bool clear)
+{
+    static char     page[TABLESIZE];
+    MemDeltaHdr_t   hdr;
+    pMemDirtyPage_t pages = NULL;
+    uint64_t        num, idx;
+    int             blk, status = MEM_GOOD_STATUS;
+    FILE*           fp;
+
+    SyncMemWriteBehind();
+
+    if ((fp = fopen(filename, "wb")) == NULL)
+    {
+        printf("DumpDelta: ***Error --- failed to open %s\n", filename);
+        return MEM_BAD_STATUS;
+    }
+
+    num = GetDirtyPages(node, NULL, 0);
+
+    if (num && ((pages = malloc(num * sizeof(MemDirtyPage_t))) == NULL))
+    {
+        printf("DumpDelta: ***Error --- failed to allocate memory\n");
+        fclose(fp);
+        return MEM_BAD_STATUS;
+    }
+
+    GetDirtyPages(node, pages, num);
+
+    hdr.magic      = MEM_DELTA_MAGIC;
+    hdr.version    = MEM_DELTA_VERSION;
+    hdr.page_size  = TABLESIZE;
+    hdr.block_size = MEM_DIRTY_BLOCK_SIZE;
+    hdr.pages      = num;
+
+    if (fwrite(&hdr, sizeof(MemDeltaHdr_t), 1, fp) != 1)
+    {
+        status = MEM_BAD_STATUS;
+    }
+
+    for (idx = 0; idx < num && status == MEM_GOOD_STATUS; idx++)
+    {
+        // Read without the checks and profiling of a user's access
+        MemPeekBlock(node, pages[idx].addr, page, TABLESIZE);
+
+        if (fwrite(&pages[idx], sizeof(MemDirtyPage_t), 1, fp) != 1)
+        {
+            status = MEM_BAD_STATUS;
+        }
+
+        for (blk = 0; blk < 64 && status == MEM_GOOD_STATUS; blk++)
+        {
+            if ((pages[idx].mask >> blk) & 1ULL)
+            {
+                if (fwrite(page + blk * MEM_DIRTY_BLOCK_SIZE, MEM_DIRTY_BLOCK_SIZE, 1, fp) != 1)
+                {
+                    status = MEM_BAD_STATUS;
+                }
+            }
+        }
+    }
+
+    if (status != MEM_GOOD_STATUS)
+    {
+        printf("DumpDelta: ***Error --- failed to write to %s\n", filename);
+    }
+    else if (clear)
+    {
+        ClearDirty(node);
+    }
+
+    free(pages);
+    fclose(fp);
+
+    return status;
+}
+
+// -------------------------------------------------------------------------
+// LoadDelta()
+//
+// Apply a delta dump from filename to a node's memory
+//
+// -------------------------------------------------------------------------
+
+int LoadDelta(const uint32_t node, const char* filename)
+{
+    static char    blk_data[MEM_DIRTY_BLOCK_SIZE];
+    MemDeltaHdr_t  hdr;
+    MemDirtyPage_t page;
+    uint64_t       idx;
+    int            blk;
+    FILE*          fp;
+
+    SyncMemWriteBehind();
+
+    if ((fp = fopen(filename, "rb")) == NULL)
+    {
+        printf("LoadDelta: ***Error --- failed to open %s\n", filename);
+        return MEM_BAD_STATUS;
+    }
+
+    if (fread(&hdr, sizeof(MemDeltaHdr_t), 1, fp) != 1 ||
+        hdr.magic      != MEM_DELTA_MAGIC                ||
+        hdr.version    != MEM_DELTA_VERSION              ||
+        hdr.page_size  != TABLESIZE                      ||
+        hdr.block_size != MEM_DIRTY_BLOCK_SIZE)
+    {
+        printf("LoadDelta: ***Error --- %s is not a compatible delta dump\n", filename);
+        fclose(fp);
+        return MEM_BAD_STATUS;
+    }
+
+    for (idx = 0; idx < hdr.pages; idx++)
+    {
+        if (fread(&page, sizeof(MemDirtyPage_t), 1, fp) != 1)
+        {
+            break;
+        }
+
+        for (blk = 0; blk < 64; blk++)
+        {
+            if ((page.mask >> blk) & 1ULL)
+            {
+                if (fread(blk_data, MEM_DIRTY_BLOCK_SIZE, 1, fp) != 1)
+                {
+                    break;
+                }
+                MemWriteBlock(node, page.addr + blk * MEM_DIRTY_BLOCK_SIZE, blk_data, MEM_DIRTY_BLOCK_SIZE);
+            }
+        }
+
+        if (blk != 64)
+        {
+            break;
+        }
+    }
+
+    fclose(fp);
+
+    if (idx != hdr.pages)
+    {
+        printf("LoadDelta: ***Error --- %s is truncated\n", filename);
+        return MEM_BAD_STATUS;
+    }
+
+    return MEM_GOOD_STATUS;
+}
@@ -0,0 +1,66 @@
+//=====================================================================
+//
+// mem_dirty.h                                        Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_DIRTY_H_
+#define _MEM_DIRTY_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include "mem.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Dirty tracking modes
+#define MEM_DIRTY_OFF           0
+#define MEM_DIRTY_PAGE          1           // Whole pages marked dirty
+#define MEM_DIRTY_SUBPAGE       2           // 64 byte blocks within pages marked dirty
+
+#define MEM_DIRTY_BLOCK_BITS    6
+#define MEM_DIRTY_BLOCK_SIZE    (1 << MEM_DIRTY_BLOCK_BITS)
+
+#define MEM_DELTA_MAGIC         0x4d4d444cUL   // "MMDL"
+#define MEM_DELTA_VERSION       1
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// A dirty page, with a bit set in mask for each dirty 64 byte block
+// (all bits set for page granularity tracking)
+typedef struct {
+    uint64_t addr;
+    uint64_t mask;
+} MemDirtyPage_t, *pMemDirtyPage_t;
+
+// Delta dump format: a MemDeltaHdr_t, followed by hdr.pages MemDirtyPage_t
+// records, in address order, each followed by the data of its dirty
+// blocks in ascending address order. All fields are host endian.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t page_size;
+    uint32_t block_size;
+    uint64_t pages;
+} MemDeltaHdr_t, *pMemDeltaHdr_t;
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern void     SetDirtyTracking    (const uint32_t node, const int mode);
+extern void     MarkDirty           (const uint32_t node, const uint64_t addr, const uint64_t len);
+extern uint64_t GetDirtyPages       (const uint32_t node, MemDirtyPage_t* pages, const uint64_t max);
+extern void     ClearDirty          (const uint32_t node);
+extern int      DumpDelta           (const uint32_t node, const char* filename, const bool clear);
+extern int      LoadDelta           (const uint32_t node, const char* filename);
+
+#endif
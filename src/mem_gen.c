@@ -0,0 +1,294 @@
+//=====================================================================
+//
+// mem_gen.c                                          Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Procedurally generated memory contents. A generator is registered
+// for a range of a heap backed node's address space, and each page of
+// the range is filled by the generator when first accessed, by a
+// read or a write. A generated page that has not been written can be
+// dropped, rather than spilled or compressed, and generated again
+// when next accessed. Generators are reference counted, by the lists
+// of the nodes using them and by the pages they have generated, so
+// that dropped pages can always be regenerated, even if shared with
+// cloned nodes, or no longer in a node's list of generators. A
+// generator's slot is reused once nothing references it.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "mem_gen.h"
+#include "mem_wb.h"
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static MemGen_t  Gen[MEM_GEN_MAX];
+
+static int       NodeGen[VP_MAX_NODES][MEM_GEN_NODE_MAX];
+static int       NodeNumGen[VP_MAX_NODES];
+
+// -------------------------------------------------------------------------
+// NewMemGenerator()
+//
+// Add a generator for the pages covering len bytes from addr of a
+// node, returning its number, or MEM_GEN_NONE if no space.
+//
+// -------------------------------------------------------------------------
+
+static int NewMemGenerator(const uint32_t node, const uint64_t addr, const uint64_t len)
+{
+    int gen;
+
+    if (len == 0)
+    {
+        printf("AddMemGenerator: ***Error --- zero length range\n");
+        return MEM_GEN_NONE;
+    }
+
+    // Find a slot that nothing references
+    for (gen = 0; gen < MEM_GEN_MAX && Gen[gen].refs; gen++);
+
+    if (gen == MEM_GEN_MAX || NodeNumGen[node] == MEM_GEN_NODE_MAX)
+    {
+        printf("AddMemGenerator: ***Error --- too many generators\n");
+        return MEM_GEN_NONE;
+    }
+
+    memset(&Gen[gen], 0, sizeof(MemGen_t));
+
+    Gen[gen].start = addr & ~TABLEMASK;
+    Gen[gen].end   = (addr + len - 1) & ~TABLEMASK;
+    Gen[gen].refs  = 1;
+
+    NodeGen[node][NodeNumGen[node]++] = gen;
+
+    return gen;
+}
+
+// -------------------------------------------------------------------------
+// AddMemGenerator()
+//
+// Add a MEM_GEN_ADDRESS or MEM_GEN_LFSR generator for the pages
+// covering len bytes from addr of a node, with words stored in the
+// byte order set by little_endian, as for WriteRamWord(). Earlier
+// generators take precedence where ranges overlap.
+//
+// -------------------------------------------------------------------------
+
+int AddMemGenerator(const uint32_t node, const uint64_t addr, const uint64_t len, const int type, const uint64_t seed, const int little_endian)
+{
+    int gen;
+
+    SyncMemWriteBehind();
+
+    if (type != MEM_GEN_ADDRESS && type != MEM_GEN_LFSR)
+    {
+        printf("AddMemGenerator: ***Error --- invalid generator type %d\n", type);
+        return MEM_BAD_STATUS;
+    }
+
+    if ((gen = NewMemGenerator(node, addr, len)) == MEM_GEN_NONE)
+    {
+        return MEM_BAD_STATUS;
+    }
+
+    Gen[gen].type          = type;
+    Gen[gen].seed          = seed;
+    Gen[gen].little_endian = little_endian;
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// AddMemGeneratorCb()
+//
+// Add a generator for the pages covering len bytes from addr of a
+// node, where each page is filled by callback, which is passed the
+// page address and context.
+//
+// -------------------------------------------------------------------------
+
+int AddMemGeneratorCb(const uint32_t node, const uint64_t addr, const uint64_t len, const pMemGenCb_t callback, void* context)
+{
+    int gen;
+
+    SyncMemWriteBehind();
+
+    if ((gen = NewMemGenerator(node, addr, len)) == MEM_GEN_NONE)
+    {
+        return MEM_BAD_STATUS;
+    }
+
+    Gen[gen].type     = MEM_GEN_CALLBACK;
+    Gen[gen].callback = callback;
+    Gen[gen].context  = context;
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// ClearMemGenerators()
+//
+// Remove a node's generators, so that pages not yet accessed are no
+// longer generated. Pages already generated keep their contents.
+//
+// -------------------------------------------------------------------------
+
+void ClearMemGenerators(const uint32_t node)
+{
+    int idx;
+
+    SyncMemWriteBehind();
+
+    for (idx = 0; idx < NodeNumGen[node]; idx++)
+    {
+        ReleaseMemGenerator(NodeGen[node][idx]);
+    }
+
+    NodeNumGen[node] = 0;
+}
+
+// -------------------------------------------------------------------------
+// CloneMemGenerators()
+//
+// Give node dst the same generators as node src, in place of its own
+//
+// -------------------------------------------------------------------------
+
+void CloneMemGenerators(const uint32_t src, const uint32_t dst)
+{
+    int idx;
+
+    SyncMemWriteBehind();
+
+    // Hold src's generators first, in case they are also dst's
+    for (idx = 0; idx < NodeNumGen[src]; idx++)
+    {
+        HoldMemGenerator(NodeGen[src][idx]);
+    }
+
+    ClearMemGenerators(dst);
+
+    memcpy(NodeGen[dst], NodeGen[src], sizeof(NodeGen[src]));
+
+    NodeNumGen[dst] = NodeNumGen[src];
+}
+
+// -------------------------------------------------------------------------
+// HoldMemGenerator()
+//
+// Add a reference to a generator, from a node's list of generators
+// or a page it has generated
+//
+// -------------------------------------------------------------------------
+
+void HoldMemGenerator(const int gen)
+{
+    Gen[gen].refs++;
+}
+
+// -------------------------------------------------------------------------
+// ReleaseMemGenerator()
+//
+// Drop a reference to a generator, freeing its slot for reuse when no
+// longer referenced
+//
+// -------------------------------------------------------------------------
+
+void ReleaseMemGenerator(const int gen)
+{
+    if (--Gen[gen].refs == 0)
+    {
+        memset(&Gen[gen], 0, sizeof(MemGen_t));
+    }
+}
+
+// -------------------------------------------------------------------------
+// FindMemGenerator()
+//
+// Return the number of the generator covering addr on a node, or
+// MEM_GEN_NONE if there is none.
+//
+// -------------------------------------------------------------------------
+
+int FindMemGenerator(const uint32_t node, const uint64_t addr)
+{
+    uint64_t page_addr = addr & ~TABLEMASK;
+    int idx, gen;
+
+    for (idx = 0; idx < NodeNumGen[node]; idx++)
+    {
+        gen = NodeGen[node][idx];
+
+        if (page_addr >= Gen[gen].start && page_addr <= Gen[gen].end)
+        {
+            return gen;
+        }
+    }
+
+    return MEM_GEN_NONE;
+}
+
+// -------------------------------------------------------------------------
+// GenerateMemPage()
+//
+// Fill buf with the contents of the page at addr from a generator.
+// MEM_GEN_ADDRESS pages hold the address of each 32 bit word, and
+// MEM_GEN_LFSR pages a sequence of 64 bit words from an xorshift
+// LFSR, with its state started from the seed and page address, so
+// that any page can be generated independently. Words are stored
+// in the generator's byte order.
+//
+// -------------------------------------------------------------------------
+
+void GenerateMemPage(const int gen, const uint64_t addr, char* buf)
+{
+    pMemGen_t g = &Gen[gen];
+    uint8_t*  p = (uint8_t*)buf;
+    uint64_t  x;
+    uint32_t  word;
+    int       idx, b;
+
+    switch (g->type)
+    {
+    case MEM_GEN_ADDRESS:
+        for (idx = 0; idx < TABLESIZE; idx += 4)
+        {
+            word = (uint32_t)(addr + idx);
+            for (b = 0; b < 4; b++)
+            {
+                p[idx + b] = (uint8_t)(word >> (g->little_endian ? (b*8) : ((3-b)*8)));
+            }
+        }
+        break;
+
+    case MEM_GEN_LFSR:
+        // Mix the seed and page address, avoiding a zero LFSR state
+        x  = MemHash64(g->seed ^ addr) | 1;
+
+        for (idx = 0; idx < TABLESIZE; idx += 8)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+
+            for (b = 0; b < 8; b++)
+            {
+                p[idx + b] = (uint8_t)(x >> (g->little_endian ? (b*8) : ((7-b)*8)));
+            }
+        }
+        break;
+
+    case MEM_GEN_CALLBACK:
+        g->callback(addr, p, g->context);
+        break;
+    }
+}
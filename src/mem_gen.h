@@ -0,0 +1,65 @@
+//=====================================================================
+//
+// mem_gen.h                                          Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_GEN_H_
+#define _MEM_GEN_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include "mem.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Generator types
+#define MEM_GEN_ADDRESS         0           // Each 32 bit word is its own address
+#define MEM_GEN_LFSR            1           // Pseudo-random 64 bit words from a seed
+#define MEM_GEN_CALLBACK        2           // Pages filled by a user function
+
+#define MEM_GEN_NONE            (-1)
+
+// Generators in total, and per node. Generator numbers must fit in the
+// bottom bits of a page address.
+#define MEM_GEN_MAX             256
+#define MEM_GEN_NODE_MAX        16
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Callback to fill the 4K page at addr
+typedef void (*pMemGenCb_t)(const uint64_t addr, uint8_t* page, void* context);
+
+typedef struct {
+    int         type;
+    uint64_t    start;              // First page address of range
+    uint64_t    end;                // Last page address of range
+    uint64_t    seed;
+    int         little_endian;      // Byte order of generated words
+    pMemGenCb_t callback;
+    void*       context;
+    uint32_t    refs;               // Node lists and generated pages using the generator (0 = free)
+} MemGen_t, *pMemGen_t;
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern int      AddMemGenerator     (const uint32_t node, const uint64_t addr, const uint64_t len, const int type, const uint64_t seed, const int little_endian);
+extern int      AddMemGeneratorCb   (const uint32_t node, const uint64_t addr, const uint64_t len, const pMemGenCb_t callback, void* context);
+extern void     ClearMemGenerators  (const uint32_t node);
+extern void     CloneMemGenerators  (const uint32_t src, const uint32_t dst);
+extern int      FindMemGenerator    (const uint32_t node, const uint64_t addr);
+extern void     HoldMemGenerator    (const int gen);
+extern void     ReleaseMemGenerator (const int gen);
+extern void     GenerateMemPage     (const int gen, const uint64_t addr, char* buf);
+
+#endif
@@ -0,0 +1,38 @@
+//=====================================================================
+//
+// mem_hash.h                                         Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Hash mixer shared by the model's hash tables, in both the C model
+// (mem.h) and the header only C++ model (mem.hpp)
+//
+//=====================================================================
+
+#ifndef _MEM_HASH_H_
+#define _MEM_HASH_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------
+// INLINE FUNCTIONS
+// -------------------------------------------------------------------------
+
+// Mix all the bits of x into a hash (the splitmix64 finaliser), so that
+// clustered page and region numbers still spread across a table
+static inline uint64_t MemHash64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+
+    return x;
+}
+
+#endif
@@ -0,0 +1,281 @@
+//=====================================================================
+//
+// mem_lz.c                                           Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// A small, fast LZ77 codec for compressing memory pages, in the
+// style of LZ4. Compressed data is a series of sequences, each a
+// token byte (upper nibble literal count, lower nibble match length
+// less MEM_LZ_MIN_MATCH, with 15 meaning further length bytes
+// follow, each adding up to 255), the literal bytes, and then a two
+// byte little endian match offset and any extra match length bytes.
+// The final sequence has only literals, and ends when the
+// decompressed data reaches its known length.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "mem.h"
+#include "mem_lz.h"
+
+// -------------------------------------------------------------------------
+// Load32()
+//
+// Unaligned load of four bytes
+//
+// -------------------------------------------------------------------------
+
+static inline uint32_t Load32(const uint8_t* p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(uint32_t));
+
+    return v;
+}
+
+// -------------------------------------------------------------------------
+// LzHash()
+//
+// Hash four bytes into a match table index
+//
+// -------------------------------------------------------------------------
+
+static inline uint32_t LzHash(const uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - MEM_LZ_HASH_BITS);
+}
+
+// -------------------------------------------------------------------------
+// PutLength()
+//
+// Output the extra bytes of a length whose token nibble is 15.
+// Returns the updated output index, or 0 if out of space.
+//
+// -------------------------------------------------------------------------
+
+static uint32_t PutLength(uint32_t len, uint8_t* dst, uint32_t op, const uint32_t max)
+{
+    for (len -= 15; len >= 255; len -= 255)
+    {
+        if (op >= max)
+        {
+            return 0;
+        }
+        dst[op++] = 255;
+    }
+
+    if (op >= max)
+    {
+        return 0;
+    }
+    dst[op++] = (uint8_t)len;
+
+    return op;
+}
+
+// -------------------------------------------------------------------------
+// PutSequence()
+//
+// Output a sequence of lit_len literals from lit, followed by a match
+// at offset of match_len bytes (if match_len is non-zero). Returns
+// the updated output index, or 0 if out of space.
+//
+// -------------------------------------------------------------------------
+
+static uint32_t PutSequence(const uint8_t* lit, const uint32_t lit_len, const uint32_t offset, const uint32_t match_len,
+                            uint8_t* dst, uint32_t op, const uint32_t max)
+{
+    uint32_t ml    = match_len ? match_len - MEM_LZ_MIN_MATCH : 0;
+    uint32_t token = ((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15);
+
+    if (op >= max)
+    {
+        return 0;
+    }
+    dst[op++] = (uint8_t)token;
+
+    if (lit_len >= 15 && (op = PutLength(lit_len, dst, op, max)) == 0)
+    {
+        return 0;
+    }
+
+    if (op + lit_len > max)
+    {
+        return 0;
+    }
+    memcpy(dst + op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len)
+    {
+        if (op + 2 > max)
+        {
+            return 0;
+        }
+        dst[op++] = (uint8_t)offset;
+        dst[op++] = (uint8_t)(offset >> 8);
+
+        if (ml >= 15 && (op = PutLength(ml, dst, op, max)) == 0)
+        {
+            return 0;
+        }
+    }
+
+    return op;
+}
+
+// -------------------------------------------------------------------------
+// MemLzCompress()
+//
+// Compress len bytes of src into dst, of max bytes. Returns the
+// compressed length, or 0 if it would not fit in max bytes. Inputs
+// are limited to 64Kbytes.
+//
+// -------------------------------------------------------------------------
+
+uint32_t MemLzCompress(const uint8_t* src, const uint32_t len, uint8_t* dst, const uint32_t max)
+{
+    uint16_t table[1 << MEM_LZ_HASH_BITS];
+    uint32_t ip = 0, anchor = 0, op = 0;
+    uint32_t h, cand, match_len, seq;
+
+    memset(table, 0, sizeof(table));
+
+    while (ip + MEM_LZ_MIN_MATCH <= len)
+    {
+        seq      = Load32(src + ip);
+        h        = LzHash(seq);
+        cand     = table[h];
+        table[h] = (uint16_t)ip;
+
+        if (cand < ip && ip - cand <= MEM_LZ_MAX_OFFSET && Load32(src + cand) == seq)
+        {
+            for (match_len = MEM_LZ_MIN_MATCH; ip + match_len < len && src[cand + match_len] == src[ip + match_len]; match_len++)
+                ;
+
+            if ((op = PutSequence(src + anchor, ip - anchor, ip - cand, match_len, dst, op, max)) == 0)
+            {
+                return 0;
+            }
+
+            ip    += match_len;
+            anchor = ip;
+        }
+        else
+        {
+            // Step faster through data that isn't matching
+            ip += 1 + ((ip - anchor) >> 6);
+        }
+    }
+
+    return PutSequence(src + anchor, len - anchor, 0, 0, dst, op, max);
+}
+
+// -------------------------------------------------------------------------
+// GetLength()
+//
+// Add the extra bytes of a length whose token nibble is 15. Returns
+// the updated input index, or 0 if the input is truncated.
+//
+// -------------------------------------------------------------------------
+
+static uint32_t GetLength(uint32_t* length, const uint8_t* src, uint32_t ip, const uint32_t len)
+{
+    uint8_t b;
+
+    do
+    {
+        if (ip >= len)
+        {
+            return 0;
+        }
+        b        = src[ip++];
+        *length += b;
+    } while (b == 255);
+
+    return ip;
+}
+
+// -------------------------------------------------------------------------
+// MemLzDecompress()
+//
+// Decompress len bytes of src into exactly dst_len bytes of dst.
+// Returns MEM_GOOD_STATUS, or MEM_BAD_STATUS if src is not valid
+// compressed data of that length.
+//
+// -------------------------------------------------------------------------
+
+int MemLzDecompress(const uint8_t* src, const uint32_t len, uint8_t* dst, const uint32_t dst_len)
+{
+    uint32_t ip = 0, op = 0;
+    uint32_t token, lit_len, match_len, offset, idx;
+
+    while (ip < len)
+    {
+        token   = src[ip++];
+        lit_len = token >> 4;
+
+        if (lit_len == 15 && (ip = GetLength(&lit_len, src, ip, len)) == 0)
+        {
+            return MEM_BAD_STATUS;
+        }
+
+        if (ip + lit_len > len || op + lit_len > dst_len)
+        {
+            return MEM_BAD_STATUS;
+        }
+        memcpy(dst + op, src + ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        // Final sequence has no match
+        if (op == dst_len)
+        {
+            return ip == len ? MEM_GOOD_STATUS : MEM_BAD_STATUS;
+        }
+
+        if (ip + 2 > len)
+        {
+            return MEM_BAD_STATUS;
+        }
+        offset  = src[ip] | (src[ip+1] << 8);
+        ip     += 2;
+
+        match_len = token & 0xf;
+
+        if (match_len == 15 && (ip = GetLength(&match_len, src, ip, len)) == 0)
+        {
+            return MEM_BAD_STATUS;
+        }
+        match_len += MEM_LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > op || op + match_len > dst_len)
+        {
+            return MEM_BAD_STATUS;
+        }
+
+        // Matches may overlap their own output (e.g. runs of a repeated byte)
+        if (offset >= match_len)
+        {
+            memcpy(dst + op, dst + op - offset, match_len);
+            op += match_len;
+        }
+        else
+        {
+            for (idx = 0; idx < match_len; idx++, op++)
+            {
+                dst[op] = dst[op - offset];
+            }
+        }
+    }
+
+    // Ran out of input before the final, literal only, sequence
+    return MEM_BAD_STATUS;
+}
@@ -0,0 +1,33 @@
+//=====================================================================
+//
+// mem_lz.h                                           Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_LZ_H_
+#define _MEM_LZ_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define MEM_LZ_MIN_MATCH        4
+#define MEM_LZ_MAX_OFFSET       0xffff
+#define MEM_LZ_HASH_BITS        12
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern uint32_t MemLzCompress       (const uint8_t* src, const uint32_t len, uint8_t* dst, const uint32_t max);
+extern int      MemLzDecompress     (const uint8_t* src, const uint32_t len, uint8_t* dst, const uint32_t dst_len);
+
+#endif
@@ -11,8 +11,16 @@
 #include <errno.h>
 #include <unistd.h>
 
+#if !defined(_WIN32)
+#include <sys/time.h>
+#else
+#include <windows.h>
+#endif
+
 #include "mem_model.h"
 #include "mem_model_pli.h"
+#include "mem_wb.h"
+#include "mem_prof.h"
 
 #if !defined(VPROC_VHDL) && !defined(VPROC_SV)
 
@@ -42,9 +50,11 @@ static int getArgs (vpiHandle taskHdl, int value[])
 }
 
 /////////////////////////////////////////////////////////////
-// Update task arguments using VPI calls
+// Update task arguments using VPI calls. Only those
+// arguments whose (1 based) position bit is set in mask
+// are updated.
 //
-static int updateArgs (vpiHandle taskHdl, int value[])
+static int updateArgs (vpiHandle taskHdl, int value[], const uint32_t mask)
 {
   int                 idx = 0;
   struct t_vpi_value  argval;
@@ -54,7 +64,7 @@ static int updateArgs (vpiHandle taskHdl, int value[])
 
   while (argh = vpi_scan(args_iter))
   {
-      if (idx == (MEM_MODEL_DATA_ARG-1))
+      if (mask & (1U << (idx+1)))
       {
           argval.format        = vpiIntVal;
           argval.value.integer = value[idx];
@@ -67,43 +77,107 @@ static int updateArgs (vpiHandle taskHdl, int value[])
   return idx;
 }
 
-#endif
+/////////////////////////////////////////////////////////////
+// Get the words of a memory (array) task argument
+//
+static void getArrayArg (vpiHandle argh, uint32_t value[], const int len)
+{
+  struct t_vpi_value   argval;
+  vpiHandle            wordh;
+  int                  idx;
+
+  for (idx = 0; idx < len; idx++)
+  {
+    if ((wordh = vpi_handle_by_index(argh, idx)) != NULL)
+    {
+      argval.format    = vpiIntVal;
+
+      vpi_get_value(wordh, &argval);
+      value[idx]       = argval.value.integer;
+    }
+  }
+}
 
 /////////////////////////////////////////////////////////////
-// PLI access function for $memread.
-//   Argument 1 is word address
-//   Argument 2 is 32 bit return data
-MEM_RTN_TYPE MemRead (MEM_READ_PARAMS)
+// Update the words of a memory (array) task argument
+//
+static void putArrayArg (vpiHandle argh, const uint32_t value[], const int len)
 {
-    uint32_t data_int, addr;
+  struct t_vpi_value   argval;
+  vpiHandle            wordh;
+  int                  idx;
 
-#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+  for (idx = 0; idx < len; idx++)
+  {
+    if ((wordh = vpi_handle_by_index(argh, idx)) != NULL)
+    {
+      argval.format        = vpiIntVal;
+      argval.value.integer = value[idx];
 
-    uint32_t           address, be;
-    vpiHandle          taskHdl;
-    int                args[10];
+      vpi_put_value(wordh, &argval, NULL, vpiNoDelay);
+    }
+  }
+}
 
-    // Obtain a handle to the argument list
-    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+/////////////////////////////////////////////////////////////
+// Get the arguments of a burst task, with the integer
+// arguments placed in value, and handles to the memory
+// (array) arguments, which follow them, placed in mem
+//
+static int getBurstArgs (vpiHandle taskHdl, int value[], vpiHandle mem[])
+{
+  int                  idx = 0;
+  struct t_vpi_value   argval;
+  vpiHandle            argh;
 
-    getArgs(taskHdl, &args[1]);
+  vpiHandle            args_iter = vpi_iterate(vpiArgument, taskHdl);
 
-    address   = args[MEM_MODEL_ADDR_ARG];
-    be        = args[MEM_MODEL_BE_ARG];
+  while (argh = vpi_scan(args_iter))
+  {
+    if (idx < MEM_MODEL_BURST_DATA_ARG-1)
+    {
+      argval.format    = vpiIntVal;
+
+      vpi_get_value(argh, &argval);
+      value[idx]       = argval.value.integer;
+    }
+    else if (idx < MEM_MODEL_BURST_BE_ARG)
+    {
+      mem[idx - (MEM_MODEL_BURST_DATA_ARG-1)] = argh;
+    }
+
+    idx++;
+  }
+
+  return idx;
+}
 
 #endif
 
-    // Get data  from memory model
+/////////////////////////////////////////////////////////////
+// Read the enabled byte lanes of the 32 bit word at address,
+// with the data returned in its lanes
+//
+static uint32_t ReadWordBe (const uint32_t address, const uint32_t be)
+{
+    uint32_t data, addr;
+
+    // Return bytes still to be written by the write-behind worker, if running
+    if (MemWbRead(address, be, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE, &data))
+    {
+        return data;
+    }
+
     if (be == 0x1 || be == 0x2 || be == 0x4 || be == 0x8)
     {
         // Ensure address is 32 bit aligned, then add bottom bits based on byte enables
         addr = (address & ~0x3UL) | ((be == 0x01) ? 0 : (be == 0x02) ? 1 : (be == 0x04) ? 2 : 3);
 
         // Get the byte from the memory model
-        data_int = ReadRamByte(addr, MEM_MODEL_DEFAULT_NODE);
+        data = ReadRamByte(addr, MEM_MODEL_DEFAULT_NODE);
 
         // Place in the correct lane
-        data_int <<= (addr & 0x3) * 8;
+        data <<= (addr & 0x3) * 8;
     }
     else if (be == 0x3 || be == 0xc)
     {
@@ -111,20 +185,164 @@ MEM_RTN_TYPE MemRead (MEM_READ_PARAMS)
         addr = (address & ~0x3UL) | ((be == 0x03) ? 0 : 2);
 
         // Get the half word from the model
-        data_int = ReadRamHWord(addr, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE);
+        data = ReadRamHWord(addr, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE);
 
         // Place in the correct lane
-        data_int <<= (addr & 0x3) * 8;
+        data <<= (addr & 0x3) * 8;
+    }
+    else
+        data = ReadRamWord(address, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE);
+
+    return data;
+}
+
+/////////////////////////////////////////////////////////////
+// Write the enabled byte lanes of data to the 32 bit word
+// at address
+//
+static void WriteWordBe (const uint32_t address, const uint32_t data, const uint32_t be)
+{
+    uint32_t addr, lane;
+
+    // Queue for the write-behind worker, if running
+    if (MemWbWrite(address, data, be, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE))
+    {
+        return;
+    }
+
+    if (be == 0x1 || be == 0x2 || be == 0x4 || be == 0x8)
+    {
+        // Ensure address is 32 bit aligned, then add bottom bits based on byte enables
+        addr = (address & ~0x3UL) | ((be == 0x01) ? 0 : (be == 0x02) ? 1 : (be == 0x04) ? 2 : 3);
+
+        WriteRamByte(addr, data >> ((addr & 0x3)*8), MEM_MODEL_DEFAULT_NODE);
+    }
+    else if (be == 0x3 || be == 0xc)
+    {
+        // Ensure address is 32 bit aligned, then add bottom bits based on byte enables
+        addr = (address & ~0x3UL) | ((be == 0x03) ? 0 : 2);
+
+        uint32_t d = data >> ((addr & 0x3ULL)*8);
+
+        WriteRamHWord(addr, d, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE);
+    }
+    else if (be == 0xf || be == 0x0)
+    {
+        WriteRamWord(address, data, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE);
     }
     else
-        data_int = ReadRamWord(address, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE);
+    {
+        // Sparse byte enables, so write each enabled lane separately
+        for (lane = 0; lane < 4; lane++)
+        {
+            if (be & (1U << lane))
+            {
+                WriteRamByte((address & ~0x3UL) | lane, data >> (lane*8), MEM_MODEL_DEFAULT_NODE);
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////
+// Return the byte address of beat of a burst starting at
+// address, with transfers of 2^size bytes. If wrap is
+// non-zero, the burst wraps at a boundary of wrap transfers.
+//
+static uint32_t BurstBeatAddr (const uint32_t address, const int size, const int wrap, const int beat)
+{
+    uint32_t bytes = 1U << size;
+    uint32_t boundary, base;
+
+    if (wrap == 0)
+    {
+        return address + beat * bytes;
+    }
+
+    boundary = wrap * bytes;
+    base     = address & ~(boundary - 1);
+
+    return base + ((address - base + beat * bytes) & (boundary - 1));
+}
+
+/////////////////////////////////////////////////////////////
+// Return the byte lanes of a 32 bit word used by a transfer
+// of 2^size bytes at address
+//
+static uint32_t BurstLanes (const uint32_t address, const int size)
+{
+    return (size >= 2) ? 0xf : (size == 1) ? (0x3U << (address & 0x2)) : (0x1U << (address & 0x3));
+}
+
+/////////////////////////////////////////////////////////////
+// Burst read of len transfers into data, one 32 bit word per
+// transfer, with each transfer's data in its byte lanes
+//
+static void ReadBurst (const uint32_t address, const int size, const int len, const int wrap, uint32_t data[])
+{
+    uint32_t addr;
+    int      beat;
+
+    for (beat = 0; beat < len && beat < MEM_MODEL_MAX_BURST; beat++)
+    {
+        addr       = BurstBeatAddr(address, size, wrap, beat);
+        data[beat] = ReadWordBe(addr, BurstLanes(addr, size));
+    }
+}
+
+/////////////////////////////////////////////////////////////
+// Burst write of len transfers from data, one 32 bit word per
+// transfer, with only the byte lanes of each transfer that
+// are also set in its byte enables written
+//
+static void WriteBurst (const uint32_t address, const int size, const int len, const int wrap, const uint32_t data[], const uint32_t be[])
+{
+    uint32_t addr, lanes;
+    int      beat;
+
+    for (beat = 0; beat < len && beat < MEM_MODEL_MAX_BURST; beat++)
+    {
+        addr  = BurstBeatAddr(address, size, wrap, beat);
+        lanes = BurstLanes(addr, size) & be[beat];
+
+        if (lanes)
+        {
+            WriteWordBe(addr, data[beat], lanes);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////
+// PLI access function for $memread.
+//   Argument 1 is word address
+//   Argument 2 is 32 bit return data
+MEM_RTN_TYPE MemRead (MEM_READ_PARAMS)
+{
+    uint32_t data_int;
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+
+    uint32_t           address, be;
+    vpiHandle          taskHdl;
+    int                args[10];
+
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+
+    getArgs(taskHdl, &args[1]);
+
+    address   = args[MEM_MODEL_ADDR_ARG];
+    be        = args[MEM_MODEL_BE_ARG];
+
+#endif
+
+    data_int = ReadWordBe(address, be);
 
 #if defined(VPROC_VHDL) || defined(VPROC_SV)
     *data = data_int;
 #else
 
     args[MEM_MODEL_DATA_ARG] = data_int;
-    updateArgs(taskHdl, &args[1]);
+    updateArgs(taskHdl, &args[1], 1U << MEM_MODEL_DATA_ARG);
 
 #endif
 }
@@ -135,8 +353,6 @@ MEM_RTN_TYPE MemRead (MEM_READ_PARAMS)
 //   Argument 2 is 32 bit data
 MEM_RTN_TYPE MemWrite (MEM_WRITE_PARAMS)
 {
-    uint32_t addr;
-
 #if !defined(VPROC_VHDL) && !defined(VPROC_SV)
     uint32_t           address, data, be;
     vpiHandle          taskHdl;
@@ -153,26 +369,321 @@ MEM_RTN_TYPE MemWrite (MEM_WRITE_PARAMS)
 
 #endif
 
-    // Update data in memory model
-    if (be == 0x1 || be == 0x2 || be == 0x4 || be == 0x8)
-    {
-        // Ensure address is 32 bit aligned, then add bottom bits based on byte enables
-        addr = (address & ~0x3UL) | ((be == 0x01) ? 0 : (be == 0x02) ? 1 : (be == 0x04) ? 2 : 3);
+    WriteWordBe(address, data, be);
+}
 
-        WriteRamByte(addr, data >> ((addr & 0x3)*8), MEM_MODEL_DEFAULT_NODE);
-    }
-    else if (be == 0x3 || be == 0xc)
-    {
-        // Ensure address is 32 bit aligned, then add bottom bits based on byte enables
-        addr = (address & ~0x3UL) | ((be == 0x03) ? 0 : 2);
+/////////////////////////////////////////////////////////////
+// PLI access function for $memreadburst.
+//   Argument 1 is byte address of first transfer
+//   Argument 2 is transfer size (bytes = 2^size, up to 4)
+//   Argument 3 is number of transfers (up to 16)
+//   Argument 4 is wrap boundary in transfers (0 for incrementing)
+//   Argument 5 is returned array of 32 bit data, one per transfer
+MEM_RTN_TYPE MemReadBurst (MEM_RBURST_PARAMS)
+{
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    uint32_t           data[MEM_MODEL_MAX_BURST];
+    int                address, size, len, wrap;
+    vpiHandle          taskHdl;
+    vpiHandle          mem[2];
+    int                args[10];
 
-        uint32_t d = data >> ((addr & 0x3ULL)*8);
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
 
-        WriteRamHWord(addr, d, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE);
-    }
-    else
+    getBurstArgs(taskHdl, &args[1], mem);
+
+    address   = args[MEM_MODEL_BURST_ADDR_ARG];
+    size      = args[MEM_MODEL_BURST_SIZE_ARG];
+    len       = args[MEM_MODEL_BURST_LEN_ARG];
+    wrap      = args[MEM_MODEL_BURST_WRAP_ARG];
+#endif
+
+    ReadBurst((uint32_t)address, size, len, wrap, (uint32_t*)data);
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    putArrayArg(mem[0], data, len < MEM_MODEL_MAX_BURST ? len : MEM_MODEL_MAX_BURST);
+
+    return 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////
+// PLI access function for $memwriteburst.
+//   Argument 1 is byte address of first transfer
+//   Argument 2 is transfer size (bytes = 2^size, up to 4)
+//   Argument 3 is number of transfers (up to 16)
+//   Argument 4 is wrap boundary in transfers (0 for incrementing)
+//   Argument 5 is array of 32 bit data, one per transfer
+//   Argument 6 is array of byte enables, one per transfer
+MEM_RTN_TYPE MemWriteBurst (MEM_WBURST_PARAMS)
+{
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    uint32_t           data[MEM_MODEL_MAX_BURST];
+    uint32_t           be[MEM_MODEL_MAX_BURST];
+    int                address, size, len, wrap;
+    vpiHandle          taskHdl;
+    vpiHandle          mem[2];
+    int                args[10];
+
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+
+    getBurstArgs(taskHdl, &args[1], mem);
+
+    address   = args[MEM_MODEL_BURST_ADDR_ARG];
+    size      = args[MEM_MODEL_BURST_SIZE_ARG];
+    len       = args[MEM_MODEL_BURST_LEN_ARG];
+    wrap      = args[MEM_MODEL_BURST_WRAP_ARG];
+
+    getArrayArg(mem[0], data, len < MEM_MODEL_MAX_BURST ? len : MEM_MODEL_MAX_BURST);
+    getArrayArg(mem[1], be,     len < MEM_MODEL_MAX_BURST ? len : MEM_MODEL_MAX_BURST);
+#endif
+
+    WriteBurst((uint32_t)address, size, len, wrap, (const uint32_t*)data, (const uint32_t*)be);
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    return 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////
+// PLI access function for $memtimingsubmit.
+//   Argument 1 is timing model instance
+//   Argument 2 is write-not-read
+//   Argument 3 is transaction ID
+//   Argument 4 is upper 32 bits of byte address
+//   Argument 5 is lower 32 bits of byte address
+//   Argument 6 is length in beats
+//   Argument 7 is beat size (bytes = 2^size, as AxSIZE)
+//   Argument 8 is current clock cycle
+//   Argument 9 is returned accepted flag
+MEM_RTN_TYPE MemTimingSubmit (MEM_TSUBMIT_PARAMS)
+{
+    int                acc;
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    int                inst, wnr, id, addr_hi, address, len, size, cycle;
+    vpiHandle          taskHdl;
+    int                args[10];
+
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+
+    getArgs(taskHdl, &args[1]);
+
+    inst      = args[MEM_MODEL_TINST_ARG];
+    wnr       = args[MEM_MODEL_TWNR_ARG];
+    id        = args[MEM_MODEL_TSUB_ID_ARG];
+    addr_hi   = args[MEM_MODEL_TSUB_ADDRH_ARG];
+    address   = args[MEM_MODEL_TSUB_ADDR_ARG];
+    len       = args[MEM_MODEL_TSUB_LEN_ARG];
+    size      = args[MEM_MODEL_TSUB_SIZE_ARG];
+    cycle     = args[MEM_MODEL_TSUB_CYCLE_ARG];
+#endif
+
+    acc = SubmitTimingReq(inst, wnr, (uint32_t)id, ((uint64_t)(uint32_t)addr_hi << 32) | (uint32_t)address,
+                          (uint32_t)len, (uint32_t)size, (uint32_t)cycle);
+
+#if defined(VPROC_VHDL) || defined(VPROC_SV)
+    *accepted = acc;
+#else
+
+    args[MEM_MODEL_TSUB_ACC_ARG] = acc;
+    updateArgs(taskHdl, &args[1], 1U << MEM_MODEL_TSUB_ACC_ARG);
+
+    return 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////
+// PLI access function for $memtimingpoll.
+//   Argument 1 is timing model instance
+//   Argument 2 is write-not-read
+//   Argument 3 is current clock cycle
+//   Argument 4 is returned valid flag
+//   Argument 5 is returned transaction ID
+//   Argument 6 is returned upper 32 bits of byte address
+//   Argument 7 is returned lower 32 bits of byte address
+//   Argument 8 is returned length in beats
+MEM_RTN_TYPE MemTimingPoll (MEM_TPOLL_PARAMS)
+{
+    uint32_t           rid = 0, rlen = 0;
+    uint64_t           raddr = 0;
+    int                rvalid;
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    int                inst, wnr, cycle;
+    vpiHandle          taskHdl;
+    int                args[10];
+
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+
+    getArgs(taskHdl, &args[1]);
+
+    inst      = args[MEM_MODEL_TINST_ARG];
+    wnr       = args[MEM_MODEL_TWNR_ARG];
+    cycle     = args[MEM_MODEL_TPOLL_CYCLE_ARG];
+#endif
+
+    rvalid = PollTimingRsp(inst, wnr, (uint32_t)cycle, &rid, &raddr, &rlen);
+
+#if defined(VPROC_VHDL) || defined(VPROC_SV)
+    *valid   = rvalid;
+    *id      = (int)rid;
+    *addr_hi = (int)(raddr >> 32);
+    *address = (int)raddr;
+    *len     = (int)rlen;
+#else
+
+    args[MEM_MODEL_TPOLL_VALID_ARG] = rvalid;
+    args[MEM_MODEL_TPOLL_ID_ARG]    = (int)rid;
+    args[MEM_MODEL_TPOLL_ADDRH_ARG] = (int)(raddr >> 32);
+    args[MEM_MODEL_TPOLL_ADDR_ARG]  = (int)raddr;
+    args[MEM_MODEL_TPOLL_LEN_ARG]   = (int)rlen;
+
+    updateArgs(taskHdl, &args[1], (1U << MEM_MODEL_TPOLL_VALID_ARG) | (1U << MEM_MODEL_TPOLL_ID_ARG)  |
+                                  (1U << MEM_MODEL_TPOLL_ADDRH_ARG) | (1U << MEM_MODEL_TPOLL_ADDR_ARG) |
+                                  (1U << MEM_MODEL_TPOLL_LEN_ARG));
+
+    return 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////
+// PLI access function for $memfill.
+//   Argument 1 is node
+//   Argument 2 is byte address
+//   Argument 3 is 32 bit fill pattern
+//   Argument 4 is length in bytes
+MEM_RTN_TYPE MemFillTask (MEM_FILL_PARAMS)
+{
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    int                node, address, pattern, len;
+    vpiHandle          taskHdl;
+    int                args[10];
+
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+
+    getArgs(taskHdl, &args[1]);
+
+    node      = args[MEM_MODEL_FILL_NODE_ARG];
+    address   = args[MEM_MODEL_FILL_ADDR_ARG];
+    pattern   = args[MEM_MODEL_FILL_PATTERN_ARG];
+    len       = args[MEM_MODEL_FILL_LEN_ARG];
+#endif
+
+    MemFill((uint32_t)node, (uint32_t)address, (uint32_t)pattern, (uint32_t)len, MEM_MODEL_DEFAULT_ENDIAN);
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    return 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////
+// PLI access function for $memcopy.
+//   Argument 1 is destination node
+//   Argument 2 is destination byte address
+//   Argument 3 is source node
+//   Argument 4 is source byte address
+//   Argument 5 is length in bytes
+MEM_RTN_TYPE MemCopyTask (MEM_COPY_PARAMS)
+{
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    int                dst_node, dst, src_node, src, len;
+    vpiHandle          taskHdl;
+    int                args[10];
+
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+
+    getArgs(taskHdl, &args[1]);
+
+    dst_node  = args[MEM_MODEL_COPY_DNODE_ARG];
+    dst       = args[MEM_MODEL_COPY_DST_ARG];
+    src_node  = args[MEM_MODEL_COPY_SNODE_ARG];
+    src       = args[MEM_MODEL_COPY_SRC_ARG];
+    len       = args[MEM_MODEL_COPY_LEN_ARG];
+#endif
+
+    MemCopy((uint32_t)dst_node, (uint32_t)dst, (uint32_t)src_node, (uint32_t)src, (uint32_t)len);
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    return 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////
+// PLI access function for $memhosttime.
+//   Argument 1 is returned host (wall clock) time in
+//   microseconds since the first call
+MEM_RTN_TYPE MemHostTime (MEM_HTIME_PARAMS)
+{
+    static uint64_t    start = 0;
+    uint64_t           now;
+
+#if !defined(_WIN32)
+    struct timeval     tv;
+#endif
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    vpiHandle          taskHdl;
+    int                args[10];
+#endif
+
+    // Time spent applying queued writes counts towards the elapsed time
+    SyncMemWriteBehind();
+
+#if !defined(_WIN32)
+    gettimeofday(&tv, NULL);
+    now       = (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+#else
+    now       = (uint64_t)GetTickCount64() * 1000ULL;
+#endif
+
+    if (start == 0)
     {
-        WriteRamWord(address, data, MEM_MODEL_DEFAULT_ENDIAN, MEM_MODEL_DEFAULT_NODE);
+        start = now;
     }
 
+#if defined(VPROC_VHDL) || defined(VPROC_SV)
+    *usec = (int)(now - start);
+#else
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+
+    args[MEM_MODEL_HTIME_ARG] = (int)(now - start);
+    updateArgs(taskHdl, &args[1], 1U << MEM_MODEL_HTIME_ARG);
+
+    return 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////
+// PLI access function for $memprofcycle.
+//   Argument 1 is upper 32 bits of current simulated cycle
+//   Argument 2 is lower 32 bits of current simulated cycle
+MEM_RTN_TYPE MemProfileCycleTask (MEM_PCYCLE_PARAMS)
+{
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    int                cycle_hi, cycle;
+    vpiHandle          taskHdl;
+    int                args[10];
+
+    // Obtain a handle to the argument list
+    taskHdl            = vpi_handle(vpiSysTfCall, NULL);
+
+    getArgs(taskHdl, &args[1]);
+
+    cycle_hi  = args[MEM_MODEL_PCYCLE_HI_ARG];
+    cycle     = args[MEM_MODEL_PCYCLE_ARG];
+#endif
+
+    MemProfileCycle(((uint64_t)(uint32_t)cycle_hi << 32) | (uint64_t)(uint32_t)cycle);
+
+#if !defined(VPROC_VHDL) && !defined(VPROC_SV)
+    return 0;
+#endif
 }
@@ -26,13 +26,62 @@
 #endif
 
 #include "mem.h"
+#include "mem_timing.h"
 
-#define MEM_MODEL_TF_TBL_SIZE 2
+#define MEM_MODEL_TF_TBL_SIZE 10
 
 #define MEM_MODEL_ADDR_ARG          1
 #define MEM_MODEL_DATA_ARG          2
 #define MEM_MODEL_BE_ARG            3
 
+// $memtimingsubmit and $memtimingpoll argument positions
+#define MEM_MODEL_TINST_ARG         1
+#define MEM_MODEL_TWNR_ARG          2
+#define MEM_MODEL_TSUB_ID_ARG       3
+#define MEM_MODEL_TSUB_ADDRH_ARG    4
+#define MEM_MODEL_TSUB_ADDR_ARG     5
+#define MEM_MODEL_TSUB_LEN_ARG      6
+#define MEM_MODEL_TSUB_SIZE_ARG     7
+#define MEM_MODEL_TSUB_CYCLE_ARG    8
+#define MEM_MODEL_TSUB_ACC_ARG      9
+
+#define MEM_MODEL_TPOLL_CYCLE_ARG   3
+#define MEM_MODEL_TPOLL_VALID_ARG   4
+#define MEM_MODEL_TPOLL_ID_ARG      5
+#define MEM_MODEL_TPOLL_ADDRH_ARG   6
+#define MEM_MODEL_TPOLL_ADDR_ARG    7
+#define MEM_MODEL_TPOLL_LEN_ARG     8
+
+// $memfill and $memcopy argument positions
+#define MEM_MODEL_FILL_NODE_ARG     1
+#define MEM_MODEL_FILL_ADDR_ARG     2
+#define MEM_MODEL_FILL_PATTERN_ARG  3
+#define MEM_MODEL_FILL_LEN_ARG      4
+
+#define MEM_MODEL_COPY_DNODE_ARG    1
+#define MEM_MODEL_COPY_DST_ARG      2
+#define MEM_MODEL_COPY_SNODE_ARG    3
+#define MEM_MODEL_COPY_SRC_ARG      4
+#define MEM_MODEL_COPY_LEN_ARG      5
+
+// $memreadburst and $memwriteburst argument positions
+#define MEM_MODEL_BURST_ADDR_ARG    1
+#define MEM_MODEL_BURST_SIZE_ARG    2
+#define MEM_MODEL_BURST_LEN_ARG     3
+#define MEM_MODEL_BURST_WRAP_ARG    4
+#define MEM_MODEL_BURST_DATA_ARG    5
+#define MEM_MODEL_BURST_BE_ARG      6
+
+// $memhosttime argument position
+#define MEM_MODEL_HTIME_ARG         1
+
+// $memprofcycle argument positions
+#define MEM_MODEL_PCYCLE_HI_ARG     1
+#define MEM_MODEL_PCYCLE_ARG        2
+
+// Most transfers in a burst passed to $memreadburst or $memwriteburst
+#define MEM_MODEL_MAX_BURST         16
+
 #define MEM_MODEL_DEFAULT_NODE      0
 
 #define MEM_MODEL_BE                0
@@ -48,6 +97,14 @@
 
 #define MEM_READ_PARAMS    const int  address,       int* data, const int be
 #define MEM_WRITE_PARAMS   const int  address, const int  data, const int be
+#define MEM_TSUBMIT_PARAMS const int  inst,    const int  wnr,  const int id, const int addr_hi, const int address, const int len, const int size, const int cycle, int* accepted
+#define MEM_TPOLL_PARAMS   const int  inst,    const int  wnr,  const int cycle, int* valid, int* id, int* addr_hi, int* address, int* len
+#define MEM_FILL_PARAMS    const int  node,    const int  address, const int pattern, const int len
+#define MEM_COPY_PARAMS    const int  dst_node, const int dst,  const int src_node, const int src, const int len
+#define MEM_RBURST_PARAMS  const int  address, const int  size, const int len, const int wrap, int* data
+#define MEM_WBURST_PARAMS  const int  address, const int  size, const int len, const int wrap, const int* data, const int* be
+#define MEM_HTIME_PARAMS   int* usec
+#define MEM_PCYCLE_PARAMS  const int  cycle_hi, const int  cycle
 
 #define MEM_RTN_TYPE       void
 
@@ -55,12 +112,28 @@
 
 #define MEM_MODEL_VPI_TBL \
   {vpiSysTask, 0, "$memread",     MemRead,     0, 0, 0}, \
-  {vpiSysTask, 0, "$memwrite",    MemWrite,    0, 0, 0}
-
-#define MEM_MODEL_VPI_TBL_SIZE 2
-
-#define MEM_READ_PARAMS   char* userdata
-#define MEM_WRITE_PARAMS  char* userdata
+  {vpiSysTask, 0, "$memwrite",    MemWrite,    0, 0, 0}, \
+  {vpiSysTask, 0, "$memtimingsubmit", MemTimingSubmit, 0, 0, 0}, \
+  {vpiSysTask, 0, "$memtimingpoll",   MemTimingPoll,   0, 0, 0}, \
+  {vpiSysTask, 0, "$memfill",     MemFillTask, 0, 0, 0}, \
+  {vpiSysTask, 0, "$memcopy",     MemCopyTask, 0, 0, 0}, \
+  {vpiSysTask, 0, "$memreadburst",  MemReadBurst,  0, 0, 0}, \
+  {vpiSysTask, 0, "$memwriteburst", MemWriteBurst, 0, 0, 0}, \
+  {vpiSysTask, 0, "$memhosttime",   MemHostTime,   0, 0, 0}, \
+  {vpiSysTask, 0, "$memprofcycle",  MemProfileCycleTask, 0, 0, 0}
+
+#define MEM_MODEL_VPI_TBL_SIZE 10
+
+#define MEM_READ_PARAMS    char* userdata
+#define MEM_WRITE_PARAMS   char* userdata
+#define MEM_TSUBMIT_PARAMS char* userdata
+#define MEM_TPOLL_PARAMS   char* userdata
+#define MEM_FILL_PARAMS    char* userdata
+#define MEM_COPY_PARAMS    char* userdata
+#define MEM_RBURST_PARAMS  char* userdata
+#define MEM_WBURST_PARAMS  char* userdata
+#define MEM_HTIME_PARAMS   char* userdata
+#define MEM_PCYCLE_PARAMS  char* userdata
 
 #define MEM_RTN_TYPE int
 
@@ -68,5 +141,13 @@
 
 extern MEM_RTN_TYPE MemRead     (MEM_READ_PARAMS);
 extern MEM_RTN_TYPE MemWrite    (MEM_WRITE_PARAMS);
+extern MEM_RTN_TYPE MemTimingSubmit (MEM_TSUBMIT_PARAMS);
+extern MEM_RTN_TYPE MemTimingPoll   (MEM_TPOLL_PARAMS);
+extern MEM_RTN_TYPE MemFillTask     (MEM_FILL_PARAMS);
+extern MEM_RTN_TYPE MemCopyTask     (MEM_COPY_PARAMS);
+extern MEM_RTN_TYPE MemReadBurst    (MEM_RBURST_PARAMS);
+extern MEM_RTN_TYPE MemWriteBurst   (MEM_WBURST_PARAMS);
+extern MEM_RTN_TYPE MemHostTime     (MEM_HTIME_PARAMS);
+extern MEM_RTN_TYPE MemProfileCycleTask (MEM_PCYCLE_PARAMS);
 
 #endif
@@ -0,0 +1,979 @@
+//=====================================================================
+//
+// mem_page.c                                         Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Page storage for heap backed nodes. Each page has a descriptor,
+// and the data of all resident pages is tracked so that, when a
+// memory budget is set, cold pages can be evicted to a spill file and
+// faulted back in when next accessed. Eviction uses a clock sweep
+// over the resident pages, with pages referenced since the last sweep
+// given a second chance. Optionally, pages not accessed for a
+// while are compacted, being compressed into a smaller allocation,
+// and decompressed when next accessed. Pages may be shared between
+// cloned nodes, and are copied when written by a node sharing them.
+// Generated pages not written since being generated are dropped,
+// instead of being spilled or compressed, and generated again when
+// next accessed. New page buffers can be taken from a pool of ready
+// zeroed buffers, kept topped up by a background helper thread, so
+// that allocation is off the simulation's critical path.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#endif
+
+#include "mem.h"
+#include "mem_wb.h"
+#include "mem_lz.h"
+#include "mem_gen.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define MEM_RESIDENT_INIT_SIZE  1024
+#define MEM_SPILL_NAME_LEN      1024
+
+#define MEM_COLD_SCAN           16          // Pages looked at for an unreferenced page to evict for a prefetch
+
+#define MEM_POOL_SIZE           256         // Page buffer pool ring size (power of 2)
+#define MEM_POOL_MASK           (MEM_POOL_SIZE-1)
+#define MEM_POOL_POLL_NS        100000      // Helper thread poll interval when pool full
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static pMemPage_t* Resident      = NULL;
+static uint64_t    NumResident   = 0;
+static uint64_t    ResidentSize  = 0;
+static uint64_t    ClockHand     = 0;
+
+static uint64_t    BudgetPages   = 0;
+static int         SpillFd       = -1;
+static uint64_t    SpillNext     = 0;
+
+static bool        CompactEnable = false;
+static uint64_t    CompactHand   = 0;
+
+// Page buffer pool, a single producer, single consumer ring
+static char*       Pool[MEM_POOL_SIZE];
+static uint32_t    PoolHead      = 0;       // Next slot to fill (producer)
+static uint32_t    PoolTail      = 0;       // Next slot to take (consumer)
+
+#if !defined(_WIN32)
+static pthread_t   Helper;
+#endif
+static bool        HelperRun     = false;
+
+static MemStats_t  Stats;
+
+// -------------------------------------------------------------------------
+// AddResident()
+//
+// Add a page to the resident page list
+//
+// -------------------------------------------------------------------------
+
+static void AddResident(pMemPage_t page)
+{
+    pMemPage_t* new_list;
+    uint64_t    new_size;
+
+    if (NumResident == ResidentSize)
+    {
+        new_size = ResidentSize ? ResidentSize * 2 : MEM_RESIDENT_INIT_SIZE;
+
+        if ((new_list = realloc(Resident, new_size * sizeof(pMemPage_t))) == NULL)
+        {
+            printf("AddResident: ***Error --- failed to allocate resident page list memory\n");
+            return;
+        }
+
+        Resident     = new_list;
+        ResidentSize = new_size;
+    }
+
+    page->res_idx          = (uint32_t)NumResident;
+    Resident[NumResident++] = page;
+}
+
+// -------------------------------------------------------------------------
+// RemoveResident()
+//
+// Remove a page from the resident page list, moving the last entry
+// into its place.
+//
+// -------------------------------------------------------------------------
+
+static void RemoveResident(pMemPage_t page)
+{
+    uint64_t idx = page->res_idx;
+
+    Resident[idx]          = Resident[--NumResident];
+    Resident[idx]->res_idx = (uint32_t)idx;
+}
+
+// -------------------------------------------------------------------------
+// UngenMemPage()
+//
+// Clear a page's generated state, if set, dropping its reference to
+// the generator that filled it
+//
+// -------------------------------------------------------------------------
+
+static void UngenMemPage(pMemPage_t page)
+{
+    if (page->flags & MEM_PAGE_GENERATED)
+    {
+        ReleaseMemGenerator((int)(page->spill_off & TABLEMASK));
+        page->flags &= ~MEM_PAGE_GENERATED;
+    }
+}
+
+#if !defined(_WIN32)
+
+// -------------------------------------------------------------------------
+// SpillPage()
+//
+// Move a resident page to the spill file (or drop it, if it can be
+// generated again), returning its data buffer for reuse, or NULL on
+// an error.
+//
+// -------------------------------------------------------------------------
+
+static char* SpillPage(pMemPage_t page)
+{
+    char* buf;
+
+    // An unwritten generated page can simply be generated again
+    if ((page->flags & (MEM_PAGE_GENERATED | MEM_PAGE_WRITTEN)) == MEM_PAGE_GENERATED)
+    {
+        Stats.regenerable_pages++;
+    }
+    else
+    {
+        UngenMemPage(page);
+
+        if (!(page->flags & MEM_PAGE_SPILL_SLOT))
+        {
+            page->spill_off  = SpillNext;
+            page->flags     |= MEM_PAGE_SPILL_SLOT | MEM_PAGE_WRITTEN;
+            SpillNext       += MEM_PAGE_SIZE;
+        }
+
+        // Only write the page out if it differs from its copy in the spill file
+        if (page->flags & MEM_PAGE_WRITTEN)
+        {
+            if (pwrite(SpillFd, page->data, MEM_PAGE_SIZE, (off_t)page->spill_off) != MEM_PAGE_SIZE)
+            {
+                printf("SpillPage: ***Error --- failed to write to spill file\n");
+                return NULL;
+            }
+            Stats.spill_writes++;
+        }
+
+        page->flags &= ~MEM_PAGE_WRITTEN;
+
+        Stats.spilled_pages++;
+    }
+
+    buf        = page->data;
+    page->data = NULL;
+
+    RemoveResident(page);
+
+    Stats.evictions++;
+
+    return buf;
+}
+
+// -------------------------------------------------------------------------
+// EvictPage()
+//
+// Select a page with the clock sweep and move it to the spill file,
+// returning its data buffer for reuse. Each resident page is looked
+// at no more than once, so pages accessed by the caller (which are
+// marked as referenced) are never evicted by the same call. Returns
+// NULL if no page could be evicted.
+//
+// -------------------------------------------------------------------------
+
+static char* EvictPage(void)
+{
+    pMemPage_t page;
+    uint64_t   count;
+
+    for (count = 0; count < NumResident; count++)
+    {
+        if (ClockHand >= NumResident)
+        {
+            ClockHand = 0;
+        }
+
+        page = Resident[ClockHand];
+
+        if (page->flags & MEM_PAGE_REF)
+        {
+            page->flags &= ~MEM_PAGE_REF;
+            ClockHand++;
+            continue;
+        }
+
+        return SpillPage(page);
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------------------------
+// EvictColdPage()
+//
+// Look at up to MEM_COLD_SCAN pages from the clock hand for one that
+// is not marked as referenced, and has not just been prefetched
+// itself, and move it to the spill file,
+// returning its data buffer for reuse. No referenced marks are
+// cleared, so this may be used ahead of an EvictPage() call without
+// putting pages accessed by the caller at risk. Returns NULL if no
+// such page was found.
+//
+// -------------------------------------------------------------------------
+
+static char* EvictColdPage(void)
+{
+    uint64_t count, idx;
+
+    for (count = 0, idx = ClockHand; count < MEM_COLD_SCAN && count < NumResident; count++, idx++)
+    {
+        if (idx >= NumResident)
+        {
+            idx = 0;
+        }
+
+        if (!(Resident[idx]->flags & (MEM_PAGE_REF | MEM_PAGE_PREFETCHED)))
+        {
+            ClockHand = idx;
+            return SpillPage(Resident[idx]);
+        }
+    }
+
+    return NULL;
+}
+
+#else
+
+static char* EvictPage(void)
+{
+    return NULL;
+}
+
+static char* EvictColdPage(void)
+{
+    return NULL;
+}
+
+#endif
+
+// -------------------------------------------------------------------------
+// CompressPage()
+//
+// Replace a resident page's data with a compressed copy, if it
+// compresses to no more than MEM_COMPRESS_MAX bytes, or drop it if
+// it can be generated again. Returns true if the page's data was
+// freed.
+//
+// -------------------------------------------------------------------------
+
+static bool CompressPage(pMemPage_t page)
+{
+    static uint8_t scratch[MEM_COMPRESS_MAX];
+    uint32_t len;
+
+    // An unwritten generated page can be dropped, and generated again when needed
+    if ((page->flags & (MEM_PAGE_GENERATED | MEM_PAGE_WRITTEN)) == MEM_PAGE_GENERATED)
+    {
+        free(page->data);
+        page->data = NULL;
+
+        RemoveResident(page);
+        Stats.regenerable_pages++;
+
+        return true;
+    }
+
+    UngenMemPage(page);
+
+    if ((len = MemLzCompress((uint8_t*)page->data, MEM_PAGE_SIZE, scratch, MEM_COMPRESS_MAX)) == 0)
+    {
+        page->flags |= MEM_PAGE_INCOMPRESSIBLE;
+        return false;
+    }
+
+    if ((page->comp = malloc(len)) == NULL)
+    {
+        printf("CompressPage: ***Error --- failed to allocate compressed page memory\n");
+        return false;
+    }
+
+    memcpy(page->comp, scratch, len);
+    free(page->data);
+
+    page->data     = NULL;
+    page->comp_len = len;
+
+    RemoveResident(page);
+
+    Stats.compressions++;
+    Stats.compressed_pages++;
+    Stats.compressed_bytes += len;
+
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// CompactPages()
+//
+// Examine up to count resident pages from the compaction hand,
+// compressing those not accessed since last examined. The hand does
+// not wrap within a call, so each page is looked at no more than
+// once and pages accessed by the caller are never compressed.
+//
+// -------------------------------------------------------------------------
+
+static void CompactPages(uint64_t count)
+{
+    pMemPage_t page;
+
+    for (; count && CompactHand < NumResident; count--)
+    {
+        page = Resident[CompactHand];
+
+        if (page->flags & MEM_PAGE_ACCESSED)
+        {
+            page->flags &= ~MEM_PAGE_ACCESSED;
+            CompactHand++;
+        }
+        // A compressed page is replaced in the list by the last entry, so only
+        // move on if the page stays resident
+        else if ((page->flags & MEM_PAGE_INCOMPRESSIBLE) || !CompressPage(page))
+        {
+            CompactHand++;
+        }
+    }
+
+    if (CompactHand >= NumResident)
+    {
+        CompactHand = 0;
+    }
+}
+
+// -------------------------------------------------------------------------
+// SetMemCompaction()
+//
+// Enable or disable automatic compaction of pages. When enabled, a
+// few resident pages are examined on each page allocation or fault.
+//
+// -------------------------------------------------------------------------
+
+void SetMemCompaction(const bool enable)
+{
+    SyncMemWriteBehind();
+
+    CompactEnable = enable;
+}
+
+// -------------------------------------------------------------------------
+// CompactMem()
+//
+// Run a compaction pass over all resident pages. Pages not accessed
+// since the previous pass (or automatic compaction sweep) are
+// compressed.
+//
+// -------------------------------------------------------------------------
+
+void CompactMem(void)
+{
+    SyncMemWriteBehind();
+
+    CompactHand = 0;
+
+    CompactPages(NumResident);
+}
+
+// -------------------------------------------------------------------------
+// PopPageBuffer()
+//
+// Take a zeroed buffer from the page buffer pool, or return NULL if
+// the pool is empty
+//
+// -------------------------------------------------------------------------
+
+static char* PopPageBuffer(void)
+{
+    uint32_t tail = PoolTail;
+    char*    buf;
+
+    if (tail == __atomic_load_n(&PoolHead, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    buf = Pool[tail & MEM_POOL_MASK];
+
+    __atomic_store_n(&PoolTail, tail + 1, __ATOMIC_RELEASE);
+
+    Stats.pool_allocs++;
+
+    return buf;
+}
+
+// -------------------------------------------------------------------------
+// PushPageBuffers()
+//
+// Add new zeroed buffers to the page buffer pool until it holds count
+// buffers. Returns the number of buffers added.
+//
+// -------------------------------------------------------------------------
+
+static uint32_t PushPageBuffers(const uint32_t count)
+{
+    uint32_t head  = PoolHead;
+    uint32_t added = 0;
+    char*    buf;
+
+    while (head - __atomic_load_n(&PoolTail, __ATOMIC_ACQUIRE) < count)
+    {
+        if ((buf = malloc(MEM_PAGE_SIZE)) == NULL)
+        {
+            break;
+        }
+
+        // Touch the whole buffer, so the host OS maps it in now
+        memset(buf, 0, MEM_PAGE_SIZE);
+
+        Pool[head & MEM_POOL_MASK] = buf;
+        __atomic_store_n(&PoolHead, ++head, __ATOMIC_RELEASE);
+        added++;
+    }
+
+    return added;
+}
+
+// -------------------------------------------------------------------------
+// FillPagePool()
+//
+// Top up the page buffer pool to count buffers (at most
+// MEM_POOL_SIZE), unless the helper thread is looking after it
+//
+// -------------------------------------------------------------------------
+
+void FillPagePool(const uint32_t count)
+{
+    if (!HelperRun)
+    {
+        PushPageBuffers(count < MEM_POOL_SIZE ? count : MEM_POOL_SIZE);
+    }
+}
+
+#if !defined(_WIN32)
+
+// -------------------------------------------------------------------------
+// PoolHelper()
+//
+// Helper thread, keeping the page buffer pool full
+//
+// -------------------------------------------------------------------------
+
+static void* PoolHelper(void* arg)
+{
+    struct timespec ts = {0, MEM_POOL_POLL_NS};
+
+    (void)arg;
+
+    while (__atomic_load_n(&HelperRun, __ATOMIC_ACQUIRE))
+    {
+        if (PushPageBuffers(MEM_POOL_SIZE) == 0)
+        {
+            nanosleep(&ts, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------------------------
+// StartMemHelper()
+//
+// Start a background thread to keep a pool of new page buffers ready
+//
+// -------------------------------------------------------------------------
+
+int StartMemHelper(void)
+{
+    if (HelperRun)
+    {
+        return MEM_GOOD_STATUS;
+    }
+
+    __atomic_store_n(&HelperRun, true, __ATOMIC_RELEASE);
+
+    if (pthread_create(&Helper, NULL, PoolHelper, NULL) != 0)
+    {
+        printf("StartMemHelper: ***Error --- failed to create helper thread\n");
+        HelperRun = false;
+        return MEM_BAD_STATUS;
+    }
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// StopMemHelper()
+//
+// Stop the page buffer pool helper thread. Buffers already in the pool
+// are kept for use.
+//
+// -------------------------------------------------------------------------
+
+void StopMemHelper(void)
+{
+    if (HelperRun)
+    {
+        __atomic_store_n(&HelperRun, false, __ATOMIC_RELEASE);
+        pthread_join(Helper, NULL);
+    }
+}
+
+#else
+
+int StartMemHelper(void)
+{
+    printf("StartMemHelper: ***Error --- helper thread not supported on this platform\n");
+    return MEM_BAD_STATUS;
+}
+
+void StopMemHelper(void)
+{
+}
+
+#endif
+
+// -------------------------------------------------------------------------
+// GetPageBuffer()
+//
+// Return a buffer for page data, evicting a page to reuse its buffer
+// if at the memory budget, else taking one from the buffer pool, or
+// allocating a new one.
+//
+// -------------------------------------------------------------------------
+
+static char* GetPageBuffer(const bool zero)
+{
+    char* buf = NULL;
+
+    if (BudgetPages && NumResident >= BudgetPages)
+    {
+        if ((buf = EvictPage()) != NULL && zero)
+        {
+            memset(buf, 0, MEM_PAGE_SIZE);
+        }
+    }
+
+    if (buf == NULL && (buf = PopPageBuffer()) == NULL)
+    {
+        buf = zero ? calloc(MEM_PAGE_SIZE, 1) : malloc(MEM_PAGE_SIZE);
+    }
+
+    return buf;
+}
+
+// -------------------------------------------------------------------------
+// NewMemPage()
+//
+// Allocate a new, resident, page
+//
+// -------------------------------------------------------------------------
+
+pMemPage_t NewMemPage(void)
+{
+    pMemPage_t page;
+
+    if ((page = calloc(1, sizeof(MemPage_t))) == NULL)
+    {
+        printf("NewMemPage: ***Error --- failed to allocate page descriptor memory\n");
+        return NULL;
+    }
+
+#ifdef MEM_ZERO_NEW_PAGES
+    page->data = GetPageBuffer(true);
+#else
+    page->data = GetPageBuffer(false);
+#endif
+
+    if (page->data == NULL)
+    {
+        printf("NewMemPage: ***Error --- failed to allocate memory\n");
+        free(page);
+        return NULL;
+    }
+
+    page->flags = MEM_PAGE_REF | MEM_PAGE_ACCESSED;
+    page->refs  = 1;
+
+    AddResident(page);
+    Stats.resident_pages = NumResident;
+
+    if (CompactEnable)
+    {
+        CompactPages(MEM_COMPACT_STEP);
+    }
+
+    return page;
+}
+
+// -------------------------------------------------------------------------
+// ReadPageData()
+//
+// Get the contents of a page into buf, from its data if resident, else
+// generating it again, decompressing it or reading it from the spill
+// file
+//
+// -------------------------------------------------------------------------
+
+static int ReadPageData(const pMemPage_t page, char* buf)
+{
+    if (page->data != NULL)
+    {
+        memcpy(buf, page->data, MEM_PAGE_SIZE);
+    }
+    else if (page->flags & MEM_PAGE_GENERATED)
+    {
+        GenerateMemPage((int)(page->spill_off & TABLEMASK), page->spill_off & ~TABLEMASK, buf);
+        Stats.generations++;
+    }
+    else if (page->comp != NULL)
+    {
+        if (MemLzDecompress((uint8_t*)page->comp, page->comp_len, (uint8_t*)buf, MEM_PAGE_SIZE) != MEM_GOOD_STATUS)
+        {
+            printf("ReadPageData: ***Error --- corrupt compressed page\n");
+            return MEM_BAD_STATUS;
+        }
+    }
+#if !defined(_WIN32)
+    else if (pread(SpillFd, buf, MEM_PAGE_SIZE, (off_t)page->spill_off) != MEM_PAGE_SIZE)
+    {
+        printf("ReadPageData: ***Error --- failed to read from spill file\n");
+        return MEM_BAD_STATUS;
+    }
+#endif
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// LoadMemPage()
+//
+// Make a non-resident page resident again, either generating it again,
+// decompressing it or loading it back from the spill file, into buf,
+// or a new buffer if buf is NULL, and return its data
+//
+// -------------------------------------------------------------------------
+
+static char* LoadMemPage(pMemPage_t page, char* buf)
+{
+    if (buf == NULL && (buf = GetPageBuffer(false)) == NULL)
+    {
+        printf("LoadMemPage: ***Error --- failed to allocate memory\n");
+        return NULL;
+    }
+
+    if (ReadPageData(page, buf) != MEM_GOOD_STATUS)
+    {
+        free(buf);
+        return NULL;
+    }
+
+    if (page->flags & MEM_PAGE_GENERATED)
+    {
+        Stats.regenerable_pages--;
+    }
+    else if (page->comp != NULL)
+    {
+        free(page->comp);
+
+        Stats.compressed_pages--;
+        Stats.compressed_bytes -= page->comp_len;
+        Stats.decompressions++;
+
+        page->comp     = NULL;
+        page->comp_len = 0;
+    }
+    else
+    {
+        Stats.faults++;
+        Stats.spilled_pages--;
+    }
+
+    page->data   = buf;
+    page->flags |= MEM_PAGE_REF | MEM_PAGE_ACCESSED;
+
+    AddResident(page);
+
+    Stats.resident_pages = NumResident;
+
+    return buf;
+}
+
+// -------------------------------------------------------------------------
+// FaultMemPage()
+//
+// Make a non-resident page resident again on access, and return its
+// data
+//
+// -------------------------------------------------------------------------
+
+char* FaultMemPage(pMemPage_t page)
+{
+    char* buf;
+
+    if ((buf = LoadMemPage(page, NULL)) != NULL && CompactEnable)
+    {
+        CompactPages(MEM_COMPACT_STEP);
+    }
+
+    return buf;
+}
+
+// -------------------------------------------------------------------------
+// PrefetchMemPage()
+//
+// Make a non-resident page resident ahead of it being accessed. When
+// at the memory budget, only a page not recently referenced is
+// evicted to make room, and if there is none, the page is left
+// where it is. No referenced marks are cleared and no pages
+// compacted, so pages in use by the caller are unaffected.
+//
+// -------------------------------------------------------------------------
+
+void PrefetchMemPage(pMemPage_t page)
+{
+    char* buf = NULL;
+
+    if (page->data != NULL)
+    {
+        return;
+    }
+
+    if (BudgetPages && NumResident >= BudgetPages && (buf = EvictColdPage()) == NULL)
+    {
+        return;
+    }
+
+    // Left unreferenced, so that the clock sweep may still take it back if it is not used
+    if (LoadMemPage(page, buf) != NULL)
+    {
+        page->flags = (page->flags & ~MEM_PAGE_REF) | MEM_PAGE_PREFETCHED;
+        Stats.prefetches++;
+    }
+}
+
+// -------------------------------------------------------------------------
+// GenMemPage()
+//
+// Fill a new page at addr from generator gen, and mark it as
+// generated, so that it can be dropped and generated again until
+// written
+//
+// -------------------------------------------------------------------------
+
+void GenMemPage(pMemPage_t page, const uint64_t addr, const int gen)
+{
+    GenerateMemPage(gen, addr & ~TABLEMASK, page->data);
+
+    page->spill_off  = (addr & ~TABLEMASK) | (uint64_t)gen;
+    page->flags     |= MEM_PAGE_GENERATED;
+
+    HoldMemGenerator(gen);
+
+    Stats.generations++;
+}
+
+// -------------------------------------------------------------------------
+// CopyMemPage()
+//
+// Make a new, resident, copy of a shared page, for a node that is
+// about to write to it, and drop that node's reference to the shared
+// page. The shared page is not made resident if it is not already.
+//
+// -------------------------------------------------------------------------
+
+pMemPage_t CopyMemPage(pMemPage_t page)
+{
+    pMemPage_t copy;
+
+    if ((copy = calloc(1, sizeof(MemPage_t))) == NULL)
+    {
+        printf("CopyMemPage: ***Error --- failed to allocate page descriptor memory\n");
+        return NULL;
+    }
+
+    // Getting a buffer may evict the shared page, so only read it afterwards
+    if ((copy->data = GetPageBuffer(false)) == NULL)
+    {
+        printf("CopyMemPage: ***Error --- failed to allocate memory\n");
+        free(copy);
+        return NULL;
+    }
+
+    if (ReadPageData(page, copy->data) != MEM_GOOD_STATUS)
+    {
+        free(copy->data);
+        free(copy);
+        return NULL;
+    }
+
+    copy->flags = MEM_PAGE_REF | MEM_PAGE_ACCESSED;
+    copy->refs  = 1;
+
+    page->refs--;
+
+    AddResident(copy);
+    Stats.resident_pages = NumResident;
+
+    if (CompactEnable)
+    {
+        CompactPages(MEM_COMPACT_STEP);
+    }
+
+    return copy;
+}
+
+// -------------------------------------------------------------------------
+// FreeMemPage()
+//
+// Drop a reference to a page, freeing it when no longer referenced.
+// Its spill file slot, if any, is not reused.
+//
+// -------------------------------------------------------------------------
+
+void FreeMemPage(pMemPage_t page)
+{
+    if (--page->refs)
+    {
+        return;
+    }
+
+    if (page->data != NULL)
+    {
+        RemoveResident(page);
+        free(page->data);
+    }
+    else if (page->flags & MEM_PAGE_GENERATED)
+    {
+        Stats.regenerable_pages--;
+    }
+    else if (page->comp != NULL)
+    {
+        Stats.compressed_pages--;
+        Stats.compressed_bytes -= page->comp_len;
+        free(page->comp);
+    }
+    else
+    {
+        Stats.spilled_pages--;
+    }
+
+    UngenMemPage(page);
+
+    Stats.resident_pages = NumResident;
+
+    free(page);
+}
+
+// -------------------------------------------------------------------------
+// SetMemBudget()
+//
+// Set the budget, in bytes, for resident page data across all heap
+// backed nodes, with pages over the budget spilled to a file created
+// in spill_dir (MEM_SPILL_DEFAULT_DIR if NULL). A budget of 0 removes
+// the limit. If the new budget is lower than the current resident
+// size, pages are evicted immediately.
+//
+// -------------------------------------------------------------------------
+
+int SetMemBudget(const uint64_t bytes, const char* spill_dir)
+{
+#if !defined(_WIN32)
+    char name[MEM_SPILL_NAME_LEN];
+    char* buf;
+
+    SyncMemWriteBehind();
+
+    if (bytes && SpillFd < 0)
+    {
+        snprintf(name, MEM_SPILL_NAME_LEN, "%s/mem_model_spill_XXXXXX", spill_dir ? spill_dir : MEM_SPILL_DEFAULT_DIR);
+
+        if ((SpillFd = mkstemp(name)) < 0)
+        {
+            printf("SetMemBudget: ***Error --- failed to create spill file %s\n", name);
+            return MEM_BAD_STATUS;
+        }
+
+        // The file is only needed whilst open, so remove its name straight away
+        unlink(name);
+    }
+
+    BudgetPages  = (bytes + MEM_PAGE_SIZE - 1) / MEM_PAGE_SIZE;
+    Stats.budget = bytes;
+
+    while (BudgetPages && NumResident > BudgetPages)
+    {
+        // No page access is in progress, so referenced pages may go on a second sweep
+        if ((buf = EvictPage()) == NULL && (buf = EvictPage()) == NULL)
+        {
+            break;
+        }
+        free(buf);
+    }
+
+    Stats.resident_pages = NumResident;
+
+    return MEM_GOOD_STATUS;
+#else
+    if (bytes)
+    {
+        printf("SetMemBudget: ***Error --- memory budgets not supported on this platform\n");
+        return MEM_BAD_STATUS;
+    }
+    return MEM_GOOD_STATUS;
+#endif
+}
+
+// -------------------------------------------------------------------------
+// GetMemStats()
+//
+// Return page storage statistics
+//
+// -------------------------------------------------------------------------
+
+void GetMemStats(MemStats_t* const stats)
+{
+    // Include pages still to be allocated by queued writes
+    SyncMemWriteBehind();
+
+    Stats.resident_pages    = NumResident;
+    Stats.compression_ratio = Stats.compressed_bytes ? (double)(Stats.compressed_pages * MEM_PAGE_SIZE) / (double)Stats.compressed_bytes : 0.0;
+
+    *stats = Stats;
+}
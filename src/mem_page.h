@@ -0,0 +1,98 @@
+//=====================================================================
+//
+// mem_page.h                                         Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_PAGE_H_
+#define _MEM_PAGE_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define MEM_PAGE_SIZE           4096
+
+// Page flags
+#define MEM_PAGE_REF            0x0001      // Accessed since last eviction sweep
+#define MEM_PAGE_WRITTEN        0x0002      // Written since last loaded from the spill file
+#define MEM_PAGE_SPILL_SLOT     0x0004      // Page has a slot allocated in the spill file
+#define MEM_PAGE_ACCESSED       0x0008      // Accessed since last compaction sweep
+#define MEM_PAGE_INCOMPRESSIBLE 0x0010      // Failed to compress, and not written since
+#define MEM_PAGE_GENERATED      0x0020      // Generated, and not written since
+#define MEM_PAGE_PREFETCHED     0x0040      // Made resident ahead of access, and not accessed since
+
+// Largest compressed size worth keeping a page compressed for
+#define MEM_COMPRESS_MAX        (MEM_PAGE_SIZE/2)
+
+// Resident pages examined for compaction per page allocation or fault
+#define MEM_COMPACT_STEP        4
+
+#ifndef MEM_SPILL_DEFAULT_DIR
+#define MEM_SPILL_DEFAULT_DIR   "/tmp"
+#endif
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Descriptor for a 4K page of a heap backed node
+typedef struct {
+    char*     data;                 // Page data, or NULL if not resident
+    char*     comp;                 // Compressed page data, or NULL if not compressed
+    uint64_t  spill_off;            // Offset of page's slot in the spill file, or for a
+                                    // generated page, its address | generator number
+    uint32_t  flags;                // MEM_PAGE_xxx
+    uint32_t  res_idx;              // Index in resident page list, when resident
+    uint32_t  comp_len;             // Length of compressed page data
+    uint32_t  refs;                 // Number of node page tables referencing the page
+} MemPage_t, *pMemPage_t;
+
+typedef struct {
+    uint64_t  budget;               // Resident page data budget in bytes (0 = unlimited)
+    uint64_t  resident_pages;       // Pages with data in memory
+    uint64_t  spilled_pages;        // Pages held only in the spill file
+    uint64_t  evictions;            // Pages evicted to the spill file
+    uint64_t  spill_writes;         // Evictions that needed a write to the spill file
+    uint64_t  faults;               // Pages loaded back from the spill file
+    uint64_t  compressed_pages;     // Pages held only in compressed form
+    uint64_t  compressed_bytes;     // Memory used by compressed page data
+    uint64_t  compressions;         // Pages compressed
+    uint64_t  decompressions;       // Pages decompressed on access
+    double    compression_ratio;    // Uncompressed to compressed size of compressed pages
+    uint64_t  regenerable_pages;    // Generated pages dropped, to be generated again when accessed
+    uint64_t  generations;          // Pages filled from a generator
+    uint64_t  prefetches;           // Pages made resident ahead of access
+    uint64_t  pool_allocs;          // New page buffers taken from the buffer pool
+} MemStats_t, *pMemStats_t;
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern int        SetMemBudget      (const uint64_t bytes, const char* spill_dir);
+extern void       GetMemStats       (MemStats_t* const stats);
+extern void       SetMemCompaction  (const bool enable);
+extern void       CompactMem        (void);
+extern int        StartMemHelper    (void);
+extern void       StopMemHelper     (void);
+extern void       FillPagePool      (const uint32_t count);
+extern pMemPage_t NewMemPage        (void);
+extern char*      FaultMemPage      (pMemPage_t page);
+extern void       PrefetchMemPage   (pMemPage_t page);
+extern void       GenMemPage        (pMemPage_t page, const uint64_t addr, const int gen);
+extern pMemPage_t CopyMemPage       (pMemPage_t page);
+extern void       FreeMemPage       (pMemPage_t page);
+
+#endif
@@ -0,0 +1,333 @@
+//=====================================================================
+//
+// mem_prof.c                                         Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Memory access profiler. When running, every page access is counted
+// per page in a hash table, and at the end of each window (a number
+// of accesses, or of simulated cycles) the counts for the pages
+// accessed in the window are written out, as CSV or binary records,
+// and cleared. This gives an address heatmap over time, and the
+// working set size of each window.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "mem_prof.h"
+#include "mem_wb.h"
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static FILE*           ProfFp       = NULL;
+static int             ProfFormat;
+static int             ProfUnits;
+static uint64_t        ProfInterval;
+
+static pMemProfEntry_t ProfTbl      = NULL;
+static uint64_t        ProfSize     = 0;
+static uint64_t        ProfUsed     = 0;
+
+static uint64_t        Window       = 0;
+static uint64_t        Accesses     = 0;
+static uint64_t        Cycle        = 0;
+static uint64_t        NextCycle    = 0;
+
+// -------------------------------------------------------------------------
+// GetProfEntry()
+//
+// Find, or add, the entry for a page in the table. Entries with no
+// reads or writes are unused.
+//
+// -------------------------------------------------------------------------
+
+static pMemProfEntry_t GetProfEntry(pMemProfEntry_t tbl, const uint64_t size, const uint64_t addr, const uint32_t node)
+{
+    uint64_t idx = MemHash64((addr >> 12) ^ ((uint64_t)node << 52)) & (size - 1);
+
+    while ((tbl[idx].reads || tbl[idx].writes) && (tbl[idx].addr != addr || tbl[idx].node != node))
+    {
+        idx = (idx + 1) & (size - 1);
+    }
+
+    return &tbl[idx];
+}
+
+// -------------------------------------------------------------------------
+// ResizeProfTable()
+//
+// Double the size of the count table, rehashing the current entries
+//
+// -------------------------------------------------------------------------
+
+static int ResizeProfTable(void)
+{
+    pMemProfEntry_t new_tbl;
+    uint64_t        new_size = ProfSize ? ProfSize * 2 : MEM_PROF_INIT_SIZE;
+    uint64_t        idx;
+
+    if ((new_tbl = calloc(new_size, sizeof(MemProfEntry_t))) == NULL)
+    {
+        printf("ResizeProfTable: ***Error --- failed to allocate profile table memory\n");
+        return MEM_BAD_STATUS;
+    }
+
+    for (idx = 0; idx < ProfSize; idx++)
+    {
+        if (ProfTbl[idx].reads || ProfTbl[idx].writes)
+        {
+            *GetProfEntry(new_tbl, new_size, ProfTbl[idx].addr, ProfTbl[idx].node) = ProfTbl[idx];
+        }
+    }
+
+    free(ProfTbl);
+
+    ProfTbl  = new_tbl;
+    ProfSize = new_size;
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// CompareEntries()
+//
+// Order entries by node, then address
+//
+// -------------------------------------------------------------------------
+
+static int CompareEntries(const void* a, const void* b)
+{
+    const MemProfEntry_t* ea = (const MemProfEntry_t*)a;
+    const MemProfEntry_t* eb = (const MemProfEntry_t*)b;
+
+    if (ea->node != eb->node)
+    {
+        return ea->node < eb->node ? -1 : 1;
+    }
+
+    return ea->addr < eb->addr ? -1 : (ea->addr > eb->addr ? 1 : 0);
+}
+
+// -------------------------------------------------------------------------
+// WriteWindow()
+//
+// Write out the counts of the current window, and clear them ready
+// for the next window.
+//
+// -------------------------------------------------------------------------
+
+static void WriteWindow(void)
+{
+    MemProfWindow_t win;
+    uint64_t idx, used = 0;
+
+    // Gather the used entries to the front of the table, and sort them
+    for (idx = 0; idx < ProfSize; idx++)
+    {
+        if (ProfTbl[idx].reads || ProfTbl[idx].writes)
+        {
+            ProfTbl[used++] = ProfTbl[idx];
+        }
+    }
+
+    qsort(ProfTbl, used, sizeof(MemProfEntry_t), CompareEntries);
+
+    win.window   = Window++;
+    win.accesses = Accesses;
+    win.cycle    = Cycle;
+    win.pages    = used;
+
+    if (ProfFormat == MEM_PROF_BINARY)
+    {
+        fwrite(&win, sizeof(MemProfWindow_t), 1, ProfFp);
+        fwrite(ProfTbl, sizeof(MemProfEntry_t), used, ProfFp);
+    }
+    else
+    {
+        fprintf(ProfFp, "W,%llu,%llu,%llu,%llu,%llu\n", (long long unsigned)win.window, (long long unsigned)win.accesses,
+                                                        (long long unsigned)win.cycle,  (long long unsigned)win.pages,
+                                                        (long long unsigned)(win.pages * TABLESIZE));
+        for (idx = 0; idx < used; idx++)
+        {
+            fprintf(ProfFp, "P,%u,0x%llx,%u,%u\n", ProfTbl[idx].node, (long long unsigned)ProfTbl[idx].addr,
+                                                   ProfTbl[idx].reads, ProfTbl[idx].writes);
+        }
+    }
+
+    memset(ProfTbl, 0, ProfSize * sizeof(MemProfEntry_t));
+    ProfUsed = 0;
+}
+
+// -------------------------------------------------------------------------
+// StartMemProfile()
+//
+// Start profiling memory accesses to filename, in MEM_PROF_CSV or
+// MEM_PROF_BINARY format, with a window every interval accesses
+// (units of MEM_PROF_ACCESSES) or simulated cycles (MEM_PROF_CYCLES,
+// with time given by MemProfileCycle()).
+//
+// -------------------------------------------------------------------------
+
+int StartMemProfile(const char* filename, const int format, const int units, const uint64_t interval)
+{
+    MemProfHdr_t hdr;
+
+    SyncMemWriteBehind();
+
+    if (ProfFp != NULL)
+    {
+        printf("StartMemProfile: ***Error --- profiling already started\n");
+        return MEM_BAD_STATUS;
+    }
+
+    if (interval == 0)
+    {
+        printf("StartMemProfile: ***Error --- zero window interval\n");
+        return MEM_BAD_STATUS;
+    }
+
+    if ((ProfFp = fopen(filename, format == MEM_PROF_BINARY ? "wb" : "w")) == NULL)
+    {
+        printf("StartMemProfile: ***Error --- failed to open %s\n", filename);
+        return MEM_BAD_STATUS;
+    }
+
+    if (ProfTbl == NULL && ResizeProfTable() != MEM_GOOD_STATUS)
+    {
+        fclose(ProfFp);
+        ProfFp = NULL;
+        return MEM_BAD_STATUS;
+    }
+
+    ProfFormat   = format;
+    ProfUnits    = units;
+    ProfInterval = interval;
+    Window       = 0;
+    Accesses     = 0;
+    Cycle        = 0;
+    NextCycle    = interval;
+
+    if (format == MEM_PROF_BINARY)
+    {
+        hdr.magic     = MEM_PROF_MAGIC;
+        hdr.version   = MEM_PROF_VERSION;
+        hdr.page_size = TABLESIZE;
+        hdr.units     = units;
+        hdr.interval  = interval;
+
+        fwrite(&hdr, sizeof(MemProfHdr_t), 1, ProfFp);
+    }
+    else
+    {
+        fprintf(ProfFp, "# Memory model profile, page size %lu, window of %llu %s\n", TABLESIZE, (long long unsigned)interval,
+                                                                                   units == MEM_PROF_CYCLES ? "cycles" : "accesses");
+        fprintf(ProfFp, "# W,window,accesses,cycle,pages,working_set_bytes\n");
+        fprintf(ProfFp, "# P,node,page_address,reads,writes\n");
+    }
+
+    SetMemProfiling(true);
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// StopMemProfile()
+//
+// Stop profiling, writing out any partial window
+//
+// -------------------------------------------------------------------------
+
+void StopMemProfile(void)
+{
+    SyncMemWriteBehind();
+
+    if (ProfFp == NULL)
+    {
+        return;
+    }
+
+    SetMemProfiling(false);
+
+    if (ProfUsed)
+    {
+        WriteWindow();
+    }
+
+    fclose(ProfFp);
+    ProfFp = NULL;
+}
+
+// -------------------------------------------------------------------------
+// MemProfileCycle()
+//
+// Update the current simulated cycle, ending the window if it has
+// reached the window interval, when windows are counted in cycles.
+// Any whole windows skipped over are not output.
+//
+// -------------------------------------------------------------------------
+
+void MemProfileCycle(const uint64_t cycle)
+{
+    // Count queued writes in the window they were made in
+    SyncMemWriteBehind();
+
+    Cycle = cycle;
+
+    if (ProfFp != NULL && ProfUnits == MEM_PROF_CYCLES && cycle >= NextCycle)
+    {
+        WriteWindow();
+        NextCycle = (cycle / ProfInterval + 1) * ProfInterval;
+    }
+}
+
+// -------------------------------------------------------------------------
+// MemProfileAccess()
+//
+// Count an access to the page containing addr. Called by the memory
+// model for every page access whilst profiling.
+//
+// -------------------------------------------------------------------------
+
+void MemProfileAccess(const uint64_t addr, const uint32_t node, const bool write)
+{
+    uint64_t        page_addr = addr & ~TABLEMASK;
+    pMemProfEntry_t entry;
+
+    // Keep the table no more than half full
+    if (ProfUsed * 2 >= ProfSize && ResizeProfTable() != MEM_GOOD_STATUS)
+    {
+        return;
+    }
+
+    entry = GetProfEntry(ProfTbl, ProfSize, page_addr, node);
+
+    if (!entry->reads && !entry->writes)
+    {
+        entry->addr = page_addr;
+        entry->node = node;
+        ProfUsed++;
+    }
+
+    if (write)
+    {
+        entry->writes++;
+    }
+    else
+    {
+        entry->reads++;
+    }
+
+    Accesses++;
+
+    if (ProfUnits == MEM_PROF_ACCESSES && (Accesses % ProfInterval) == 0)
+    {
+        WriteWindow();
+    }
+}
@@ -0,0 +1,74 @@
+//=====================================================================
+//
+// mem_prof.h                                         Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_PROF_H_
+#define _MEM_PROF_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include "mem.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Output formats
+#define MEM_PROF_CSV            0
+#define MEM_PROF_BINARY         1
+
+// Window interval units
+#define MEM_PROF_ACCESSES       0
+#define MEM_PROF_CYCLES         1
+
+#define MEM_PROF_MAGIC          0x4d4d5046UL   // "MMPF"
+#define MEM_PROF_VERSION        1
+
+#define MEM_PROF_INIT_SIZE      1024
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Binary format: a MemProfHdr_t, followed by a MemProfWindow_t for each
+// window, each followed by window.pages MemProfEntry_t records, in
+// node and address order. All fields are host endian.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t page_size;
+    uint32_t units;                 // MEM_PROF_ACCESSES or MEM_PROF_CYCLES
+    uint64_t interval;              // Window length in units
+} MemProfHdr_t, *pMemProfHdr_t;
+
+typedef struct {
+    uint64_t window;                // Window number, from 0
+    uint64_t accesses;              // Total page accesses at end of window
+    uint64_t cycle;                 // Last cycle given to MemProfileCycle() at end of window
+    uint64_t pages;                 // Distinct pages accessed in window (working set)
+} MemProfWindow_t, *pMemProfWindow_t;
+
+typedef struct {
+    uint64_t addr;                  // Page address
+    uint32_t node;
+    uint32_t reads;                 // Page reads in window
+    uint32_t writes;                // Page writes in window
+    uint32_t reserved;
+} MemProfEntry_t, *pMemProfEntry_t;
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern int      StartMemProfile     (const char* filename, const int format, const int units, const uint64_t interval);
+extern void     StopMemProfile      (void);
+extern void     MemProfileCycle     (const uint64_t cycle);
+extern void     MemProfileAccess    (const uint64_t addr, const uint32_t node, const bool write);
+
+#endif
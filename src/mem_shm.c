@@ -0,0 +1,427 @@
+//=====================================================================
+//
+// mem_shm.c                                          Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// POSIX shared memory backing for memory model nodes. A node's pages
+// are held in a named shared memory segment with a self-describing
+// layout (see mem_shm.h), so that other processes can attach to the
+// same segment and access the same memory image directly.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "mem_shm.h"
+
+#if !defined(_WIN32)
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define MEM_SHM_NAME_LEN        256
+
+#define MEM_SHM_BUSY_SPIN       1024        // Polls of a busy entry before yielding
+#define MEM_SHM_BUSY_TIMEOUT_MS 1000        // Time to wait for a busy entry before giving up
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef struct {
+    pMemShmHdr_t   hdr;
+    pMemShmEntry_t hash;
+    char*          pool;
+    uint64_t       hash_mask;
+    char           name[MEM_SHM_NAME_LEN];
+} MemShmNode_t, *pMemShmNode_t;
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static MemShmNode_t ShmNode[VP_MAX_NODES];
+
+// -------------------------------------------------------------------------
+// RoundUp()
+//
+// Round a size up to a whole number of pages
+//
+// -------------------------------------------------------------------------
+
+static uint64_t RoundUp(const uint64_t size)
+{
+    return (size + MEM_SHM_PAGE_SIZE - 1) & ~((uint64_t)MEM_SHM_PAGE_SIZE - 1);
+}
+
+// -------------------------------------------------------------------------
+// ShmBusyWait()
+//
+// Wait a little for an entry being allocated by another process to be
+// published, spinning at first and then yielding. Returns false if
+// the entry has been busy for MEM_SHM_BUSY_TIMEOUT_MS, as the process
+// allocating it may have died.
+//
+// -------------------------------------------------------------------------
+
+static bool ShmBusyWait(uint32_t* spins, struct timespec* start)
+{
+    struct timespec now;
+    int64_t         ms;
+
+    if ((*spins)++ == 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, start);
+    }
+
+    if (*spins < MEM_SHM_BUSY_SPIN)
+    {
+        MemCpuRelax();
+        return true;
+    }
+
+    sched_yield();
+
+    if ((*spins % MEM_SHM_BUSY_SPIN) == 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        ms = (int64_t)(now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+
+        if (ms >= MEM_SHM_BUSY_TIMEOUT_MS)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// MapShmNode()
+//
+// Set up a node's pointers into a mapped segment
+//
+// -------------------------------------------------------------------------
+
+static void MapShmNode(const uint32_t node, void* base, const char* name)
+{
+    pMemShmNode_t s = &ShmNode[node];
+
+    s->hdr       = (pMemShmHdr_t)base;
+    s->hash      = (pMemShmEntry_t)((char*)base + s->hdr->hash_offset);
+    s->pool      = (char*)base + s->hdr->pool_offset;
+    s->hash_mask = s->hdr->hash_size - 1;
+
+    strncpy(s->name, name, MEM_SHM_NAME_LEN-1);
+    s->name[MEM_SHM_NAME_LEN-1] = '\0';
+
+    SetNodeMode(node, MEM_NODE_SHM);
+}
+
+// -------------------------------------------------------------------------
+// CreateShmMem()
+//
+// Create a named shared memory segment able to hold size bytes of
+// memory pages, and use it as the page store for node. Any existing
+// segment of the same name is unlinked and replaced by a new segment,
+// with processes still attached to the old one keeping their mapping.
+//
+// -------------------------------------------------------------------------
+
+int CreateShmMem(const uint32_t node, const char* name, const uint64_t size)
+{
+    uint64_t num_pages, hash_size, hash_bytes, seg_size;
+    pMemShmHdr_t hdr;
+    void* base;
+    int fd;
+
+    if (ShmNode[node].hdr != NULL)
+    {
+        printf("CreateShmMem: ***Error --- node %d already has a shared memory segment\n", node);
+        return MEM_BAD_STATUS;
+    }
+
+    num_pages  = RoundUp(size) / MEM_SHM_PAGE_SIZE;
+
+    // Keep the hash table no more than half full
+    for (hash_size = 1; hash_size < 2*num_pages; hash_size <<= 1)
+        ;
+
+    hash_bytes = RoundUp(hash_size * sizeof(MemShmEntry_t));
+    seg_size   = RoundUp(sizeof(MemShmHdr_t)) + hash_bytes + num_pages * MEM_SHM_PAGE_SIZE;
+
+    // Unlink, rather than truncate, an existing segment, as other processes
+    // may still have it mapped
+    shm_unlink(name);
+
+    if ((fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666)) < 0)
+    {
+        printf("CreateShmMem: ***Error --- failed to open shared memory segment %s\n", name);
+        return MEM_BAD_STATUS;
+    }
+
+    // A new segment is zero filled, so the hash table starts empty
+    if (ftruncate(fd, (off_t)seg_size) < 0)
+    {
+        printf("CreateShmMem: ***Error --- failed to size shared memory segment %s\n", name);
+        close(fd);
+        shm_unlink(name);
+        return MEM_BAD_STATUS;
+    }
+
+    base = mmap(NULL, seg_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (base == MAP_FAILED)
+    {
+        printf("CreateShmMem: ***Error --- failed to map shared memory segment %s\n", name);
+        shm_unlink(name);
+        return MEM_BAD_STATUS;
+    }
+
+    hdr               = (pMemShmHdr_t)base;
+    hdr->version      = MEM_SHM_VERSION;
+    hdr->header_size  = sizeof(MemShmHdr_t);
+    hdr->page_size    = MEM_SHM_PAGE_SIZE;
+    hdr->seg_size     = seg_size;
+    hdr->num_pages    = num_pages;
+    hdr->hash_size    = hash_size;
+    hdr->hash_offset  = RoundUp(sizeof(MemShmHdr_t));
+    hdr->pool_offset  = hdr->hash_offset + hash_bytes;
+    hdr->used_pages   = 0;
+
+    // Publish the magic number last, so attaching processes only see a complete header
+    __atomic_store_n(&hdr->magic, (uint32_t)MEM_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    MapShmNode(node, base, name);
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// AttachShmMem()
+//
+// Attach node to an existing named shared memory segment, created by
+// this or another process.
+//
+// -------------------------------------------------------------------------
+
+int AttachShmMem(const uint32_t node, const char* name)
+{
+    pMemShmHdr_t hdr;
+    struct stat st;
+    void* base;
+    int fd;
+
+    if (ShmNode[node].hdr != NULL)
+    {
+        printf("AttachShmMem: ***Error --- node %d already has a shared memory segment\n", node);
+        return MEM_BAD_STATUS;
+    }
+
+    if ((fd = shm_open(name, O_RDWR, 0666)) < 0)
+    {
+        printf("AttachShmMem: ***Error --- failed to open shared memory segment %s\n", name);
+        return MEM_BAD_STATUS;
+    }
+
+    if (fstat(fd, &st) < 0 || (uint64_t)st.st_size < sizeof(MemShmHdr_t))
+    {
+        printf("AttachShmMem: ***Error --- shared memory segment %s is not a memory model segment\n", name);
+        close(fd);
+        return MEM_BAD_STATUS;
+    }
+
+    base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (base == MAP_FAILED)
+    {
+        printf("AttachShmMem: ***Error --- failed to map shared memory segment %s\n", name);
+        return MEM_BAD_STATUS;
+    }
+
+    hdr = (pMemShmHdr_t)base;
+
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != MEM_SHM_MAGIC ||
+        hdr->version   != MEM_SHM_VERSION                                ||
+        hdr->page_size != MEM_SHM_PAGE_SIZE                              ||
+        hdr->seg_size  != (uint64_t)st.st_size)
+    {
+        printf("AttachShmMem: ***Error --- shared memory segment %s has an incompatible layout\n", name);
+        munmap(base, (size_t)st.st_size);
+        return MEM_BAD_STATUS;
+    }
+
+    MapShmNode(node, base, name);
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// DetachShmMem()
+//
+// Unmap a node's shared memory segment, returning the node to heap
+// backing. If remove is set, the segment name is also unlinked, and
+// the segment freed once all other processes have detached.
+//
+// -------------------------------------------------------------------------
+
+void DetachShmMem(const uint32_t node, const bool remove)
+{
+    pMemShmNode_t s = &ShmNode[node];
+
+    if (s->hdr == NULL)
+    {
+        return;
+    }
+
+    munmap(s->hdr, s->hdr->seg_size);
+
+    if (remove)
+    {
+        shm_unlink(s->name);
+    }
+
+    memset(s, 0, sizeof(MemShmNode_t));
+
+    SetNodeMode(node, MEM_NODE_HEAP);
+}
+
+// -------------------------------------------------------------------------
+// GetShmPage()
+//
+// Returns a pointer to the page containing addr in a node's shared
+// memory segment, allocating a page from the pool if not present and
+// alloc is set. Allocation is lock free, so that several processes
+// may access the same segment concurrently.
+//
+// -------------------------------------------------------------------------
+
+char* GetShmPage(const uint64_t addr, const uint32_t node, const bool alloc)
+{
+    pMemShmNode_t s = &ShmNode[node];
+    uint64_t page_addr = addr & ~((uint64_t)MEM_SHM_PAGE_SIZE - 1);
+    uint64_t idx, start, key, expected, page;
+    uint32_t spins = 0;
+    struct timespec busy_start;
+
+    idx = start = MemHash64(page_addr >> 12) & s->hash_mask;
+
+    while (true)
+    {
+        key = __atomic_load_n(&s->hash[idx].key, __ATOMIC_ACQUIRE);
+
+        if (key == (page_addr | MEM_SHM_KEY_VALID))
+        {
+            return s->pool + s->hash[idx].page * MEM_SHM_PAGE_SIZE;
+        }
+
+        // Another process is allocating this page, so wait for it to be published
+        if (key == (page_addr | MEM_SHM_KEY_BUSY))
+        {
+            if (!ShmBusyWait(&spins, &busy_start))
+            {
+                printf("GetShmPage: ***Error --- timed out waiting for page at 0x%llx in shared memory segment %s\n",
+                       (long long unsigned)page_addr, s->name);
+                return NULL;
+            }
+            continue;
+        }
+
+        if (key == 0)
+        {
+            if (!alloc)
+            {
+                return NULL;
+            }
+
+            // Don't leave a dead entry behind when the pool is already known to be full
+            if (__atomic_load_n(&s->hdr->used_pages, __ATOMIC_RELAXED) >= s->hdr->num_pages)
+            {
+                printf("GetShmPage: ***Error --- shared memory segment %s is full\n", s->name);
+                return NULL;
+            }
+
+            // Claim the entry. If another process got there first, re-examine it.
+            expected = 0;
+            if (!__atomic_compare_exchange_n(&s->hash[idx].key, &expected, page_addr | MEM_SHM_KEY_BUSY,
+                                             false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                continue;
+            }
+
+            page = __atomic_fetch_add(&s->hdr->used_pages, 1, __ATOMIC_RELAXED);
+
+            if (page >= s->hdr->num_pages)
+            {
+                printf("GetShmPage: ***Error --- shared memory segment %s is full\n", s->name);
+
+                // Not made unused again, as other processes may have probed past it
+                __atomic_store_n(&s->hash[idx].key, MEM_SHM_KEY_DEAD, __ATOMIC_RELEASE);
+                return NULL;
+            }
+
+            s->hash[idx].page = page;
+            __atomic_store_n(&s->hash[idx].key, page_addr | MEM_SHM_KEY_VALID, __ATOMIC_RELEASE);
+
+            return s->pool + page * MEM_SHM_PAGE_SIZE;
+        }
+
+        idx = (idx + 1) & s->hash_mask;
+
+        if (idx == start)
+        {
+            if (alloc)
+            {
+                printf("GetShmPage: ***Error --- shared memory segment %s hash table is full\n", s->name);
+            }
+            return NULL;
+        }
+    }
+}
+
+#else
+
+// -------------------------------------------------------------------------
+// Shared memory nodes are not supported on Windows builds
+// -------------------------------------------------------------------------
+
+int CreateShmMem(const uint32_t node, const char* name, const uint64_t size)
+{
+    printf("CreateShmMem: ***Error --- shared memory nodes not supported on this platform\n");
+    return MEM_BAD_STATUS;
+}
+
+int AttachShmMem(const uint32_t node, const char* name)
+{
+    printf("AttachShmMem: ***Error --- shared memory nodes not supported on this platform\n");
+    return MEM_BAD_STATUS;
+}
+
+void DetachShmMem(const uint32_t node, const bool remove)
+{
+}
+
+char* GetShmPage(const uint64_t addr, const uint32_t node, const bool alloc)
+{
+    return NULL;
+}
+
+#endif
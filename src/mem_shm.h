@@ -0,0 +1,68 @@
+//=====================================================================
+//
+// mem_shm.h                                          Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_SHM_H_
+#define _MEM_SHM_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include "mem.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define MEM_SHM_MAGIC           0x4d4d5348UL   // "MMSH"
+#define MEM_SHM_VERSION         1
+#define MEM_SHM_PAGE_SIZE       TABLESIZE
+
+// Hash entry key states. Keys are page addresses (4K aligned) with the
+// state in the bottom bits, and zero is an unused entry. A dead entry,
+// claimed but never given a page, matches no page but is probed past,
+// as other pages may have been added beyond it.
+#define MEM_SHM_KEY_VALID       1ULL
+#define MEM_SHM_KEY_BUSY        2ULL
+#define MEM_SHM_KEY_DEAD        3ULL
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Shared memory segment header, at offset 0 of the segment. All offsets
+// are in bytes from the start of the segment, so the layout is valid in
+// any process regardless of where the segment is mapped.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t page_size;
+    uint64_t seg_size;
+    uint64_t num_pages;             // Capacity of the page pool
+    uint64_t hash_size;             // Entries in the page hash table (power of 2)
+    uint64_t hash_offset;
+    uint64_t pool_offset;
+    uint64_t used_pages;            // Page pool allocation count (atomic)
+} MemShmHdr_t, *pMemShmHdr_t;
+
+typedef struct {
+    uint64_t key;                   // Page address | MEM_SHM_KEY_xxx state (atomic)
+    uint64_t page;                  // Index of page in pool
+} MemShmEntry_t, *pMemShmEntry_t;
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern int      CreateShmMem        (const uint32_t node, const char* name, const uint64_t size);
+extern int      AttachShmMem        (const uint32_t node, const char* name);
+extern void     DetachShmMem        (const uint32_t node, const bool remove);
+extern char*    GetShmPage          (const uint64_t addr, const uint32_t node, const bool alloc);
+
+#endif
@@ -0,0 +1,401 @@
+//=====================================================================
+//
+// mem_timing.c                                       Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Transaction timing model for the memory model bus wrappers. The
+// HDL submits commands as they arrive and polls for those whose
+// modelled latency has expired. Latency can be fixed, random or
+// derived from a simple open-row DRAM bank model, with an optional
+// data bandwidth limit, a bound on outstanding transactions per ID
+// and optional out-of-order completion between IDs.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "mem_timing.h"
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef struct {
+    MemTimingCfg_t cfg;
+
+    MemTimingReq_t q             [2][MEM_TIMING_MAX_OUTSTANDING];
+    uint32_t       id_count      [2][MEM_TIMING_MAX_IDS];
+    uint32_t       id_last_ready [2][MEM_TIMING_MAX_IDS];
+    uint32_t       last_ready    [2];
+    uint32_t       outstanding   [2];
+
+    uint32_t       chan_free;
+    uint32_t       bank_ready    [MEM_TIMING_MAX_BANKS];
+    uint64_t       open_row      [MEM_TIMING_MAX_BANKS];
+    bool           row_open      [MEM_TIMING_MAX_BANKS];
+
+    uint32_t       rand_state;
+    uint64_t       seq;
+} TimingInst_t, *pTimingInst_t;
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static pTimingInst_t TimingInst[MEM_TIMING_MAX_INST];
+
+// -------------------------------------------------------------------------
+// Later()
+//
+// Returns the later of two cycle times, allowing for counter wrap
+//
+// -------------------------------------------------------------------------
+
+static uint32_t Later(const uint32_t a, const uint32_t b)
+{
+    return ((int32_t)(a - b) >= 0) ? a : b;
+}
+
+// -------------------------------------------------------------------------
+// Rand32()
+//
+// An xorshift32 generator for RANDOM mode latencies
+//
+// -------------------------------------------------------------------------
+
+static uint32_t Rand32(pTimingInst_t t)
+{
+    uint32_t x = t->rand_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    return t->rand_state = x;
+}
+
+// -------------------------------------------------------------------------
+// GetInst()
+//
+// Returns the state for an instance, creating it with a default
+// (no added latency) configuration if not previously configured
+//
+// -------------------------------------------------------------------------
+
+static pTimingInst_t GetInst(const int inst)
+{
+    MemTimingCfg_t cfg;
+
+    if (inst < 0 || inst >= MEM_TIMING_MAX_INST)
+    {
+        printf("GetInst: ***Error --- timing model instance %d out of range\n", inst);
+        return NULL;
+    }
+
+    if (TimingInst[inst] == NULL)
+    {
+        DefaultTimingCfg(&cfg, MEM_TIMING_NONE);
+        ConfigTimingModel(inst, &cfg);
+    }
+
+    return TimingInst[inst];
+}
+
+// -------------------------------------------------------------------------
+// DefaultTimingCfg()
+//
+// Fills in a configuration with defaults for the given mode. The DRAM
+// defaults approximate a DDR part with 8 banks of 2KB rows.
+//
+// -------------------------------------------------------------------------
+
+void DefaultTimingCfg(MemTimingCfg_t* const cfg, const int mode)
+{
+    memset(cfg, 0, sizeof(MemTimingCfg_t));
+
+    cfg->mode            = mode;
+    cfg->latency         = (mode == MEM_TIMING_NONE) ? 0 : 10;
+    cfg->latency_max     = 40;
+    cfg->seed            = 0x5eed1234;
+    cfg->bytes_per_cycle = 0;
+    cfg->max_per_id      = 0;
+    cfg->out_of_order    = false;
+
+    cfg->col_bits        = 11;
+    cfg->bank_bits       = 3;
+    cfg->t_cas           = 11;
+    cfg->t_rcd           = 11;
+    cfg->t_rp            = 11;
+}
+
+// -------------------------------------------------------------------------
+// ConfigTimingModel()
+//
+// Configure an instance of the timing model, discarding any
+// outstanding transactions.
+//
+// -------------------------------------------------------------------------
+
+void ConfigTimingModel(const int inst, const MemTimingCfg_t* const cfg)
+{
+    if (inst < 0 || inst >= MEM_TIMING_MAX_INST)
+    {
+        printf("ConfigTimingModel: ***Error --- timing model instance %d out of range\n", inst);
+        return;
+    }
+
+    if (cfg->mode == MEM_TIMING_DRAM && (1U << cfg->bank_bits) > MEM_TIMING_MAX_BANKS)
+    {
+        printf("ConfigTimingModel: ***Error --- too many DRAM banks (max %d)\n", MEM_TIMING_MAX_BANKS);
+        return;
+    }
+
+    if (TimingInst[inst] == NULL)
+    {
+        if ((TimingInst[inst] = malloc(sizeof(TimingInst_t))) == NULL)
+        {
+            printf("ConfigTimingModel: ***Error --- failed to allocate timing model memory\n");
+            return;
+        }
+    }
+
+    memset(TimingInst[inst], 0, sizeof(TimingInst_t));
+
+    TimingInst[inst]->cfg        = *cfg;
+    TimingInst[inst]->rand_state = cfg->seed ? cfg->seed : 1;
+
+    if (TimingInst[inst]->cfg.max_per_id == 0 || TimingInst[inst]->cfg.max_per_id > MEM_TIMING_MAX_OUTSTANDING)
+    {
+        TimingInst[inst]->cfg.max_per_id = MEM_TIMING_MAX_OUTSTANDING;
+    }
+}
+
+// -------------------------------------------------------------------------
+// ResetTimingModel()
+//
+// Discard all outstanding transactions and open rows, keeping the
+// current configuration.
+//
+// -------------------------------------------------------------------------
+
+void ResetTimingModel(const int inst)
+{
+    pTimingInst_t t;
+
+    if ((t = GetInst(inst)) != NULL)
+    {
+        ConfigTimingModel(inst, &t->cfg);
+    }
+}
+
+// -------------------------------------------------------------------------
+// CalcLatency()
+//
+// Calculate the cycle at which the first data of a transaction of len
+// beats, each of 2^size bytes, is available, updating the bank and data
+// channel state.
+//
+// -------------------------------------------------------------------------
+
+static uint32_t CalcLatency(pTimingInst_t t, const uint64_t addr, const uint32_t len, const uint32_t size, const uint32_t now)
+{
+    const MemTimingCfg_t* cfg = &t->cfg;
+    uint32_t start = now;
+    uint32_t lat   = 0;
+    uint32_t xfer  = 0;
+    uint32_t data_start;
+    uint32_t bank  = 0;
+    uint64_t row;
+
+    if (cfg->bytes_per_cycle)
+    {
+        xfer = (uint32_t)(((uint64_t)len * (1ULL << (size & 0x7)) + cfg->bytes_per_cycle - 1) / cfg->bytes_per_cycle);
+    }
+
+    switch (cfg->mode)
+    {
+    case MEM_TIMING_FIXED:
+        lat = cfg->latency;
+        break;
+
+    case MEM_TIMING_RANDOM:
+        lat = cfg->latency;
+        if (cfg->latency_max > cfg->latency)
+        {
+            lat += Rand32(t) % (cfg->latency_max - cfg->latency + 1);
+        }
+        break;
+
+    case MEM_TIMING_DRAM:
+        bank  = (uint32_t)(addr >> cfg->col_bits) & ((1U << cfg->bank_bits) - 1);
+        row   = addr >> (cfg->col_bits + cfg->bank_bits);
+        start = Later(now, t->bank_ready[bank]);
+
+        if (t->row_open[bank] && t->open_row[bank] == row)
+        {
+            lat = cfg->t_cas;
+        }
+        else if (t->row_open[bank])
+        {
+            lat = cfg->t_rp + cfg->t_rcd + cfg->t_cas;
+        }
+        else
+        {
+            lat = cfg->t_rcd + cfg->t_cas;
+        }
+
+        t->row_open[bank] = true;
+        t->open_row[bank] = row;
+        break;
+
+    default:
+        break;
+    }
+
+    // Data can't start until the channel is free of earlier transfers
+    data_start   = Later(start + lat, t->chan_free);
+    t->chan_free = data_start + xfer;
+
+    if (cfg->mode == MEM_TIMING_DRAM)
+    {
+        t->bank_ready[bank] = t->chan_free;
+    }
+
+    return data_start;
+}
+
+// -------------------------------------------------------------------------
+// SubmitTimingReq()
+//
+// Submit a new transaction of len beats, each of 2^size bytes (the
+// AXI AxSIZE encoding). Returns 1 if accepted, or
+// 0 if the instance is at its outstanding transaction limit, when
+// the command must be resubmitted later.
+//
+// -------------------------------------------------------------------------
+
+int SubmitTimingReq(const int inst, const int wnr, const uint32_t id, const uint64_t addr, const uint32_t len, const uint32_t size, const uint32_t now)
+{
+    pTimingInst_t t;
+    uint32_t ready, idx;
+    int dir = wnr ? MEM_TIMING_WRITE : MEM_TIMING_READ;
+    int slot;
+
+    if ((t = GetInst(inst)) == NULL)
+    {
+        return 0;
+    }
+
+    idx = id % MEM_TIMING_MAX_IDS;
+
+    if (t->outstanding[dir] >= MEM_TIMING_MAX_OUTSTANDING || t->id_count[dir][idx] >= t->cfg.max_per_id)
+    {
+        return 0;
+    }
+
+    for (slot = 0; t->q[dir][slot].valid; slot++)
+        ;
+
+    ready = CalcLatency(t, addr, len, size, now);
+
+    // Transactions with the same ID always complete in order. Across IDs
+    // they only complete in order if out-of-order completion is disabled.
+    if (t->id_count[dir][idx])
+    {
+        ready = Later(ready, t->id_last_ready[dir][idx]);
+    }
+
+    if (!t->cfg.out_of_order && t->outstanding[dir])
+    {
+        ready = Later(ready, t->last_ready[dir]);
+    }
+
+    t->id_last_ready[dir][idx] = ready;
+    t->last_ready[dir]         = ready;
+
+    t->q[dir][slot].valid      = true;
+    t->q[dir][slot].id         = id;
+    t->q[dir][slot].addr       = addr;
+    t->q[dir][slot].len        = len;
+    t->q[dir][slot].ready      = ready;
+    t->q[dir][slot].seq        = t->seq++;
+
+    t->id_count[dir][idx]++;
+    t->outstanding[dir]++;
+
+    return 1;
+}
+
+// -------------------------------------------------------------------------
+// PollTimingRsp()
+//
+// Returns 1, with the transaction's ID, address and length, if a
+// transaction in the given direction has completed its latency by
+// cycle now, removing it from the model. Returns 0 otherwise.
+//
+// -------------------------------------------------------------------------
+
+int PollTimingRsp(const int inst, const int wnr, const uint32_t now, uint32_t* id, uint64_t* addr, uint32_t* len)
+{
+    pTimingInst_t t;
+    pMemTimingReq_t best = NULL, r;
+    int dir = wnr ? MEM_TIMING_WRITE : MEM_TIMING_READ;
+    int slot;
+
+    if ((t = GetInst(inst)) == NULL || t->outstanding[dir] == 0)
+    {
+        return 0;
+    }
+
+    for (slot = 0; slot < MEM_TIMING_MAX_OUTSTANDING; slot++)
+    {
+        r = &t->q[dir][slot];
+
+        if (r->valid && (int32_t)(now - r->ready) >= 0)
+        {
+            if (best == NULL || (int32_t)(r->ready - best->ready) < 0 || (r->ready == best->ready && r->seq < best->seq))
+            {
+                best = r;
+            }
+        }
+    }
+
+    if (best == NULL)
+    {
+        return 0;
+    }
+
+    *id   = best->id;
+    *addr = best->addr;
+    *len  = best->len;
+
+    best->valid = false;
+    t->id_count[dir][best->id % MEM_TIMING_MAX_IDS]--;
+    t->outstanding[dir]--;
+
+    return 1;
+}
+
+// -------------------------------------------------------------------------
+// TimingOutstanding()
+//
+// Returns the number of transactions outstanding in a given direction
+//
+// -------------------------------------------------------------------------
+
+int TimingOutstanding(const int inst, const int wnr)
+{
+    pTimingInst_t t;
+
+    if ((t = GetInst(inst)) == NULL)
+    {
+        return 0;
+    }
+
+    return t->outstanding[wnr ? MEM_TIMING_WRITE : MEM_TIMING_READ];
+}
@@ -0,0 +1,92 @@
+//=====================================================================
+//
+// mem_timing.h                                       Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_TIMING_H_
+#define _MEM_TIMING_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#ifndef MEM_TIMING_MAX_INST
+#define MEM_TIMING_MAX_INST         16
+#endif
+
+// Maximum number of outstanding transactions, per direction, per instance
+#ifndef MEM_TIMING_MAX_OUTSTANDING
+#define MEM_TIMING_MAX_OUTSTANDING  64
+#endif
+
+#define MEM_TIMING_MAX_IDS          256
+#define MEM_TIMING_MAX_BANKS        64
+
+// Latency modes
+#define MEM_TIMING_NONE             0
+#define MEM_TIMING_FIXED            1
+#define MEM_TIMING_RANDOM           2
+#define MEM_TIMING_DRAM             3
+
+// Transaction directions
+#define MEM_TIMING_READ             0
+#define MEM_TIMING_WRITE            1
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Timing model configuration for a single instance. All times are in
+// clock cycles of the HDL wrapper calling the model.
+typedef struct {
+    int      mode;                 // One of MEM_TIMING_xxx
+
+    uint32_t latency;              // Fixed latency, or minimum latency for RANDOM mode
+    uint32_t latency_max;          // Maximum latency for RANDOM mode
+    uint32_t seed;                 // Seed for RANDOM mode
+
+    uint32_t bytes_per_cycle;      // Bandwidth limit (0 = unlimited)
+    uint32_t max_per_id;           // Outstanding transactions per ID (0 = MEM_TIMING_MAX_OUTSTANDING)
+    bool     out_of_order;         // Allow completion out of order between different IDs
+
+    // DRAM mode parameters. Address is decoded as {row, bank, column}
+    uint32_t col_bits;             // log2 of bytes per row (page)
+    uint32_t bank_bits;            // log2 of number of banks
+    uint32_t t_cas;                // Column access latency (row hit)
+    uint32_t t_rcd;                // Row activate to column access
+    uint32_t t_rp;                 // Row precharge
+} MemTimingCfg_t, *pMemTimingCfg_t;
+
+typedef struct {
+    bool     valid;
+    uint32_t id;
+    uint64_t addr;
+    uint32_t len;
+    uint32_t ready;
+    uint64_t seq;
+} MemTimingReq_t, *pMemTimingReq_t;
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern void     ConfigTimingModel   (const int inst, const MemTimingCfg_t* const cfg);
+extern void     DefaultTimingCfg    (MemTimingCfg_t* const cfg, const int mode);
+extern void     ResetTimingModel    (const int inst);
+extern int      SubmitTimingReq     (const int inst, const int wnr, const uint32_t id, const uint64_t addr, const uint32_t len, const uint32_t size, const uint32_t now);
+extern int      PollTimingRsp       (const int inst, const int wnr, const uint32_t now, uint32_t* id, uint64_t* addr, uint32_t* len);
+extern int      TimingOutstanding   (const int inst, const int wnr);
+
+#endif
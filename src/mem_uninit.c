@@ -0,0 +1,392 @@
+//=====================================================================
+//
+// mem_uninit.c                                       Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Uninitialised read detection. When enabled for a node, a shadow
+// bitmap with a bit per byte is kept for each page written, with
+// bits set as bytes are written. Reads check the bits of the bytes
+// read, and any read of undefined bytes is reported, or passed to a
+// user callback. Copies within the model copy the shadow state with
+// the data, so that only reads of the copied data are reported.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "mem_uninit.h"
+#include "mem_gen.h"
+#include "mem_wb.h"
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef struct {
+    int          mode;
+    PageTable_t  pages;             // Shadowed pages, with the bitmap pointer as value
+    uint64_t     count;             // Reads of undefined bytes
+} MemShadowNode_t, *pMemShadowNode_t;
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static MemShadowNode_t ShadowNode[VP_MAX_NODES];
+static pMemUninitCb_t  UninitCb = NULL;
+
+// -------------------------------------------------------------------------
+// GetShadow()
+//
+// Return the shadow bitmap of the page containing addr, or NULL if it
+// has none. If alloc is set, a bitmap with all bytes undefined (or all
+// defined for a generated page) is created if not present.
+//
+// -------------------------------------------------------------------------
+
+static uint64_t* GetShadow(const uint32_t node, const uint64_t addr, const bool alloc)
+{
+    pMemShadowNode_t s         = &ShadowNode[node];
+    uint64_t         page_addr = addr & ~TABLEMASK;
+    pPageEntry_t     entry;
+    uint64_t*        bits;
+
+    if ((entry = FindPageEntry(&s->pages, page_addr)) != NULL)
+    {
+        return (uint64_t*)(uintptr_t)entry->val;
+    }
+
+    if (!alloc)
+    {
+        return NULL;
+    }
+
+    if ((bits = calloc(MEM_UNINIT_WORDS, sizeof(uint64_t))) == NULL)
+    {
+        printf("GetShadow: ***Error --- failed to allocate shadow memory\n");
+        return NULL;
+    }
+
+    // Generated pages are defined throughout
+    if (FindMemGenerator(node, page_addr) != MEM_GEN_NONE)
+    {
+        memset(bits, 0xff, MEM_UNINIT_WORDS * sizeof(uint64_t));
+    }
+
+    if (AddPageEntry(&s->pages, page_addr, (uint64_t)(uintptr_t)bits) == NULL)
+    {
+        free(bits);
+        return NULL;
+    }
+
+    return bits;
+}
+
+// -------------------------------------------------------------------------
+// RangeMask()
+//
+// Return a mask of the bits of word idx lying within bits first to
+// first+len-1 of a bitmap
+//
+// -------------------------------------------------------------------------
+
+static inline uint64_t RangeMask(const uint32_t idx, const uint32_t first, const uint32_t len)
+{
+    uint32_t lo = idx * 64;
+    uint32_t start = first > lo ? first - lo : 0;
+    uint32_t end   = (first + len) < (lo + 64) ? (first + len) - lo : 64;
+
+    return (end == 64 ? ~0ULL : ((1ULL << end) - 1)) & ~((1ULL << start) - 1);
+}
+
+// -------------------------------------------------------------------------
+// GetBits()
+//
+// Return up to 64 bits of a bitmap from bit position pos
+//
+// -------------------------------------------------------------------------
+
+static inline uint64_t GetBits(const uint64_t* bits, const uint32_t pos)
+{
+    uint32_t idx = pos >> 6, sh = pos & 63;
+    uint64_t v   = bits[idx] >> sh;
+
+    if (sh && idx + 1 < MEM_UNINIT_WORDS)
+    {
+        v |= bits[idx + 1] << (64 - sh);
+    }
+
+    return v;
+}
+
+// -------------------------------------------------------------------------
+// PutBits()
+//
+// Write len (1 to 64) bits of v to a bitmap at bit position pos
+//
+// -------------------------------------------------------------------------
+
+static inline void PutBits(uint64_t* bits, const uint32_t pos, const uint32_t len, const uint64_t v)
+{
+    uint32_t idx  = pos >> 6, sh = pos & 63;
+    uint64_t mask = len == 64 ? ~0ULL : ((1ULL << len) - 1);
+
+    bits[idx] = (bits[idx] & ~(mask << sh)) | ((v & mask) << sh);
+
+    if (sh && sh + len > 64)
+    {
+        bits[idx + 1] = (bits[idx + 1] & ~(mask >> (64 - sh))) | ((v & mask) >> (64 - sh));
+    }
+}
+
+// -------------------------------------------------------------------------
+// SetUninitCheck()
+//
+// Set the uninitialised read check mode of a node. Switching between
+// the MEM_UNINIT_TRACK, MEM_UNINIT_REPORT and MEM_UNINIT_CALLBACK
+// modes keeps the shadow state, whilst MEM_UNINIT_OFF discards it.
+// When first enabled, all of the node's memory is undefined until
+// written, or declared defined with MemSetDefined().
+//
+// -------------------------------------------------------------------------
+
+void SetUninitCheck(const uint32_t node, const int mode)
+{
+    pMemShadowNode_t s = &ShadowNode[node];
+
+    SyncMemWriteBehind();
+
+    if (mode == MEM_UNINIT_OFF)
+    {
+        ClearUninitShadow(node);
+        FreePageTable(&s->pages);
+
+        s->count = 0;
+    }
+
+    s->mode = mode;
+
+    SetMemUninitCheck(node, mode != MEM_UNINIT_OFF);
+}
+
+// -------------------------------------------------------------------------
+// ClearUninitShadow()
+//
+// Discard a node's shadow state, leaving all of its memory undefined,
+// without changing its mode or count of undefined reads
+//
+// -------------------------------------------------------------------------
+
+void ClearUninitShadow(const uint32_t node)
+{
+    pMemShadowNode_t s = &ShadowNode[node];
+    uint64_t idx;
+
+    SyncMemWriteBehind();
+
+    for (idx = 0; idx < s->pages.size; idx++)
+    {
+        free((uint64_t*)(uintptr_t)s->pages.tbl[idx].val);
+    }
+
+    ClearPageTable(&s->pages);
+}
+
+// -------------------------------------------------------------------------
+// SetUninitCallback()
+//
+// Set the function called for reads of undefined bytes, on nodes in
+// MEM_UNINIT_CALLBACK mode
+//
+// -------------------------------------------------------------------------
+
+void SetUninitCallback(const pMemUninitCb_t callback)
+{
+    SyncMemWriteBehind();
+
+    UninitCb = callback;
+}
+
+// -------------------------------------------------------------------------
+// UninitReadCount()
+//
+// Return the number of reads of undefined bytes found on a node
+//
+// -------------------------------------------------------------------------
+
+uint64_t UninitReadCount(const uint32_t node)
+{
+    WaitMemWriteBehind();
+
+    return ShadowNode[node].count;
+}
+
+// -------------------------------------------------------------------------
+// MarkDefined()
+//
+// Mark len bytes of a node's memory from addr as defined. Called by
+// the model's write path, which may be run by the write-behind worker.
+//
+// -------------------------------------------------------------------------
+
+void MarkDefined(const uint32_t node, const uint64_t addr, const uint64_t len)
+{
+    uint64_t  done = 0, chunk;
+    uint32_t  offset, idx;
+    uint64_t* bits;
+
+    while (done < len)
+    {
+        offset = (addr + done) & TABLEMASK;
+        chunk  = ((len - done) < (TABLESIZE - offset)) ? (len - done) : (TABLESIZE - offset);
+
+        if ((bits = GetShadow(node, addr + done, true)) == NULL)
+        {
+            return;
+        }
+
+        for (idx = offset >> 6; idx <= (offset + chunk - 1) >> 6; idx++)
+        {
+            bits[idx] |= RangeMask(idx, offset, (uint32_t)chunk);
+        }
+
+        done += chunk;
+    }
+}
+
+// -------------------------------------------------------------------------
+// MemSetDefined()
+//
+// Mark len bytes of a node's memory from addr as defined
+//
+// -------------------------------------------------------------------------
+
+void MemSetDefined(const uint32_t node, const uint64_t addr, const uint64_t len)
+{
+    SyncMemWriteBehind();
+
+    MarkDefined(node, addr, len);
+}
+
+// -------------------------------------------------------------------------
+// MemCheckDefined()
+//
+// Check that len bytes of a node's memory from addr are defined,
+// reporting, or calling the callback for, the first undefined byte
+// if not.
+//
+// -------------------------------------------------------------------------
+
+void MemCheckDefined(const uint32_t node, const uint64_t addr, const uint64_t len)
+{
+    pMemShadowNode_t s = &ShadowNode[node];
+    uint64_t  done = 0, chunk, undef;
+    uint64_t  bad_addr = 0;
+    bool      bad = false;
+    uint32_t  offset, idx;
+    uint64_t* bits;
+
+    WaitMemWriteBehind();
+
+    while (done < len && !bad)
+    {
+        offset = (addr + done) & TABLEMASK;
+        chunk  = ((len - done) < (TABLESIZE - offset)) ? (len - done) : (TABLESIZE - offset);
+
+        // A page with no shadow bitmap has not been written, so is only defined if generated
+        if ((bits = GetShadow(node, addr + done, false)) == NULL)
+        {
+            if (FindMemGenerator(node, addr + done) == MEM_GEN_NONE)
+            {
+                bad      = true;
+                bad_addr = addr + done;
+                break;
+            }
+
+            done += chunk;
+            continue;
+        }
+
+        for (idx = offset >> 6; idx <= (offset + chunk - 1) >> 6; idx++)
+        {
+            if ((undef = ~bits[idx] & RangeMask(idx, offset, (uint32_t)chunk)) != 0)
+            {
+                bad      = true;
+                bad_addr = ((addr + done) & ~TABLEMASK) + idx * 64 + __builtin_ctzll(undef);
+                break;
+            }
+        }
+
+        done += chunk;
+    }
+
+    if (!bad || s->mode == MEM_UNINIT_TRACK)
+    {
+        return;
+    }
+
+    s->count++;
+
+    if (s->mode == MEM_UNINIT_CALLBACK && UninitCb != NULL)
+    {
+        UninitCb(node, addr, len, bad_addr);
+    }
+    else
+    {
+        printf("MemCheckDefined: ***Warning --- read of uninitialised memory at 0x%llx on node %d (read of %llu bytes at 0x%llx)\n",
+               (long long unsigned)bad_addr, node, (long long unsigned)len, (long long unsigned)addr);
+    }
+}
+
+// -------------------------------------------------------------------------
+// MemCopyDefined()
+//
+// Copy the shadow state of len bytes from src to dst, where each range
+// lies within a single page
+//
+// -------------------------------------------------------------------------
+
+void MemCopyDefined(const uint32_t dst_node, const uint64_t dst, const uint32_t src_node, const uint64_t src, const uint64_t len)
+{
+    static uint64_t tmp[MEM_UNINIT_WORDS];
+    uint64_t* src_bits;
+    uint64_t* dst_bits;
+    uint32_t  src_off = src & TABLEMASK;
+    uint32_t  dst_off = dst & TABLEMASK;
+    uint32_t  done, chunk;
+
+    SyncMemWriteBehind();
+
+    // Source nodes without checking enabled are taken as all defined
+    if (ShadowNode[src_node].mode == MEM_UNINIT_OFF)
+    {
+        MarkDefined(dst_node, dst, len);
+        return;
+    }
+
+    if ((src_bits = GetShadow(src_node, src, false)) == NULL)
+    {
+        memset(tmp, FindMemGenerator(src_node, src) != MEM_GEN_NONE ? 0xff : 0, sizeof(tmp));
+    }
+    else
+    {
+        memcpy(tmp, src_bits, sizeof(tmp));
+    }
+
+    if ((dst_bits = GetShadow(dst_node, dst, true)) == NULL)
+    {
+        return;
+    }
+
+    // Work from a copy of the source bits, as the ranges may overlap
+    for (done = 0; done < len; done += chunk)
+    {
+        chunk = (len - done) < 64 ? (uint32_t)(len - done) : 64;
+        PutBits(dst_bits, dst_off + done, chunk, GetBits(tmp, src_off + done));
+    }
+}
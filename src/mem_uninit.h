@@ -0,0 +1,51 @@
+//=====================================================================
+//
+// mem_uninit.h                                       Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_UNINIT_H_
+#define _MEM_UNINIT_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include "mem.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Uninitialised read check modes
+#define MEM_UNINIT_OFF          0           // No shadow state kept
+#define MEM_UNINIT_TRACK        1           // Shadow state kept, but reads not checked
+#define MEM_UNINIT_REPORT       2           // Reads of undefined bytes reported
+#define MEM_UNINIT_CALLBACK     3           // Reads of undefined bytes passed to callback
+
+#define MEM_UNINIT_WORDS        (TABLESIZE/64)
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Callback for a read of len bytes from addr, where bad_addr is the
+// first undefined byte
+typedef void (*pMemUninitCb_t)(const uint32_t node, const uint64_t addr, const uint64_t len, const uint64_t bad_addr);
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern void     SetUninitCheck      (const uint32_t node, const int mode);
+extern void     SetUninitCallback   (const pMemUninitCb_t callback);
+extern void     ClearUninitShadow   (const uint32_t node);
+extern uint64_t UninitReadCount     (const uint32_t node);
+extern void     MarkDefined         (const uint32_t node, const uint64_t addr, const uint64_t len);
+extern void     MemSetDefined       (const uint32_t node, const uint64_t addr, const uint64_t len);
+extern void     MemCheckDefined     (const uint32_t node, const uint64_t addr, const uint64_t len);
+extern void     MemCopyDefined      (const uint32_t dst_node, const uint64_t dst, const uint32_t src_node, const uint64_t src, const uint64_t len);
+
+#endif
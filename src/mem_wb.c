@@ -0,0 +1,544 @@
+//=====================================================================
+//
+// mem_wb.c                                           Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Write-behind of the memory model's word writes. When started,
+// writes from the HDL interface are queued on a single producer,
+// single consumer ring, and applied to the model by a worker thread,
+// so that page lookup, allocation and copying are off the simulation's
+// critical path. The model's page tables are not shared between
+// threads, so the simulation thread only accesses the model when the
+// worker has applied all queued writes, which the model's public
+// functions wait for on entry. To keep reads after writes
+// ordered without always waiting for this, the bytes written to each
+// word are kept in a small direct mapped index, and reads of bytes
+// all found there are returned from it. Other reads wait for the
+// queued writes to be applied before reading the model.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+#include "mem_wb.h"
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// A queued write of the enabled bytes of a word
+typedef struct {
+    uint64_t  addr;                 // Word aligned byte address
+    uint32_t  node;
+    uint32_t  mask;                 // Bytes of word written
+    uint8_t   bytes[4];             // Byte values, in memory order
+} MemWbEntry_t, *pMemWbEntry_t;
+
+// Index entry, with the bytes of a word written since the index was
+// last invalidated
+typedef struct {
+    uint64_t  addr;                 // Word aligned byte address
+    uint32_t  node;
+    uint32_t  gen;                  // Valid if equal to IndexGen
+    uint32_t  mask;                 // Bytes of word held
+    uint8_t   bytes[4];             // Byte values, in memory order
+} MemWbWord_t, *pMemWbWord_t;
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static MemWbStats_t Stats;
+
+#if !defined(_WIN32)
+
+static MemWbEntry_t Ring[MEM_WB_RING_SIZE];
+static uint64_t     RingHead     = 0;       // Sequence number of next write to queue (producer)
+static uint64_t     RingTail     = 0;       // Sequence number of next write to apply (worker)
+
+static MemWbWord_t  Index[MEM_WB_INDEX_SIZE];
+static uint32_t     IndexGen     = 1;
+
+static pthread_t    Worker;
+static bool         WorkerRun    = false;
+
+// -------------------------------------------------------------------------
+// WaitApplied()
+//
+// Wait for the worker thread to have applied the queued writes before
+// sequence number seq, yielding if this takes a while, in case the
+// worker is sharing the CPU
+//
+// -------------------------------------------------------------------------
+
+static void WaitApplied(const uint64_t seq)
+{
+    uint32_t spins = 0;
+
+    while (__atomic_load_n(&RingTail, __ATOMIC_ACQUIRE) < seq)
+    {
+        if (++spins < MEM_WB_SPIN)
+        {
+            MemCpuRelax();
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// WordByte()
+//
+// Return byte i, in memory order, of a word stored with the given
+// endianness
+//
+// -------------------------------------------------------------------------
+
+static inline uint32_t WordByte(const uint32_t data, const int i, const int le)
+{
+    return (le ? (data >> (i*8)) : (data >> ((3-i)*8))) & 0xff;
+}
+
+// -------------------------------------------------------------------------
+// WriteBytes()
+//
+// Convert a write of the byte lanes of data enabled by be into the
+// bytes written, in memory order, returning the mask of bytes written.
+// Byte and half word lane enables are written as bytes and half
+// words, sparse enables as separate bytes, and anything else as a
+// whole word, matching the writes made by mem_model.c.
+//
+// -------------------------------------------------------------------------
+
+static uint32_t WriteBytes(const uint32_t data, const uint32_t be, const int le, uint8_t bytes[4])
+{
+    uint32_t data_out;
+    int      i, lo;
+
+    if (be == 0x1 || be == 0x2 || be == 0x4 || be == 0x8)
+    {
+        i        = (be == 0x1) ? 0 : (be == 0x2) ? 1 : (be == 0x4) ? 2 : 3;
+        bytes[i] = (data >> (i*8)) & 0xff;
+    }
+    else if (be == 0x3 || be == 0xc)
+    {
+        lo       = (be == 0x3) ? 0 : 2;
+        data_out = lo ? ((data >> 16) << 16) : data;
+
+        for (i = lo; i < lo+2; i++)
+        {
+            bytes[i] = WordByte(data_out, i, le);
+        }
+    }
+    else if (be == 0xf || be == 0x0)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            bytes[i] = WordByte(data, i, le);
+        }
+
+        return 0xf;
+    }
+    else
+    {
+        for (i = 0; i < 4; i++)
+        {
+            bytes[i] = (data >> (i*8)) & 0xff;
+        }
+    }
+
+    return be;
+}
+
+// -------------------------------------------------------------------------
+// ReadBytes()
+//
+// Return in data the byte lanes of a read enabled by be, from the
+// bytes of a word held in memory order, if all the bytes needed are
+// in mask. Returns false if not.
+//
+// -------------------------------------------------------------------------
+
+static bool ReadBytes(const uint32_t be, const int le, const uint8_t bytes[4], const uint32_t mask, uint32_t* const data)
+{
+    uint32_t need, d = 0;
+    int      i, lo, hi;
+
+    if (be == 0x1 || be == 0x2 || be == 0x4 || be == 0x8)
+    {
+        if ((mask & be) != be)
+        {
+            return false;
+        }
+
+        i     = (be == 0x1) ? 0 : (be == 0x2) ? 1 : (be == 0x4) ? 2 : 3;
+        *data = (uint32_t)bytes[i] << (i*8);
+
+        return true;
+    }
+
+    lo   = (be == 0xc) ? 2 : 0;
+    hi   = (be == 0x3 || be == 0xc) ? lo+2 : 4;
+    need = ((1U << hi) - 1) & ~((1U << lo) - 1);
+
+    if ((mask & need) != need)
+    {
+        return false;
+    }
+
+    for (i = lo; i < hi; i++)
+    {
+        d |= (uint32_t)bytes[i] << (le ? (i*8) : ((3-i)*8));
+    }
+
+    *data = (be == 0xc) ? ((d >> 16) << 16) : d;
+
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// IndexWord()
+//
+// Return the index entry for the word at addr
+//
+// -------------------------------------------------------------------------
+
+static inline pMemWbWord_t IndexWord(const uint64_t addr, const uint32_t node)
+{
+    return &Index[((addr >> 2) + (uint64_t)node * 0x9e37) & MEM_WB_INDEX_MASK];
+}
+
+// -------------------------------------------------------------------------
+// InvalidateIndex()
+//
+// Discard all entries of the written word index
+//
+// -------------------------------------------------------------------------
+
+static void InvalidateIndex(void)
+{
+    if (++IndexGen == 0)
+    {
+        memset(Index, 0, sizeof(Index));
+        IndexGen = 1;
+    }
+}
+
+// -------------------------------------------------------------------------
+// DrainWrites()
+//
+// Wait for the worker thread to apply all the queued writes. Waiting
+// for only those up to a particular write isn't enough, as the worker
+// would still be updating the model's page tables.
+//
+// -------------------------------------------------------------------------
+
+static void DrainWrites(void)
+{
+    if (__atomic_load_n(&RingTail, __ATOMIC_ACQUIRE) != RingHead)
+    {
+        Stats.drains++;
+        WaitApplied(RingHead);
+    }
+}
+
+// -------------------------------------------------------------------------
+// WbWorker()
+//
+// Worker thread, applying queued writes to the model
+//
+// -------------------------------------------------------------------------
+
+static void* WbWorker(void* arg)
+{
+    struct timespec ts   = {0, MEM_WB_POLL_NS};
+    uint64_t        tail = RingTail;
+    uint64_t        head;
+    uint32_t        idle = 0;
+    pMemWbEntry_t   entry;
+    PktData_t       buf[4];
+    int             i;
+
+    (void)arg;
+
+    while (true)
+    {
+        head = __atomic_load_n(&RingHead, __ATOMIC_ACQUIRE);
+
+        if (tail == head)
+        {
+            // Only stopped once all queued writes have been drained
+            if (!__atomic_load_n(&WorkerRun, __ATOMIC_ACQUIRE))
+            {
+                break;
+            }
+
+            if (++idle < MEM_WB_SPIN)
+            {
+                MemCpuRelax();
+            }
+            else
+            {
+                nanosleep(&ts, NULL);
+            }
+
+            continue;
+        }
+
+        idle = 0;
+
+        while (tail != head)
+        {
+            entry = &Ring[tail & MEM_WB_RING_MASK];
+
+            for (i = 0; i < 4; i++)
+            {
+                buf[i] = entry->bytes[i];
+            }
+
+            WriteRamByteBlock(entry->addr, buf, entry->mask, 0x0, 4, entry->node);
+
+            tail++;
+            __atomic_store_n(&RingTail, tail, __ATOMIC_RELEASE);
+        }
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------------------------
+// StartMemWriteBehind()
+//
+// Start a worker thread to apply writes made through MemWbWrite()
+//
+// -------------------------------------------------------------------------
+
+int StartMemWriteBehind(void)
+{
+    if (WorkerRun)
+    {
+        return MEM_GOOD_STATUS;
+    }
+
+    InvalidateIndex();
+
+    __atomic_store_n(&WorkerRun, true, __ATOMIC_RELEASE);
+
+    if (pthread_create(&Worker, NULL, WbWorker, NULL) != 0)
+    {
+        printf("StartMemWriteBehind: ***Error --- failed to create worker thread\n");
+        WorkerRun = false;
+        return MEM_BAD_STATUS;
+    }
+
+    return MEM_GOOD_STATUS;
+}
+
+// -------------------------------------------------------------------------
+// StopMemWriteBehind()
+//
+// Apply all queued writes and stop the worker thread
+//
+// -------------------------------------------------------------------------
+
+void StopMemWriteBehind(void)
+{
+    if (WorkerRun)
+    {
+        DrainWrites();
+
+        __atomic_store_n(&WorkerRun, false, __ATOMIC_RELEASE);
+        pthread_join(Worker, NULL);
+    }
+}
+
+// -------------------------------------------------------------------------
+// SyncMemWriteBehind()
+//
+// Wait for all queued writes to be applied, and discard the written
+// word index. Called on entry to the model's public functions that
+// change memory, page tables or their side tables, so that these are
+// never used by two threads at once. Must not be called from code
+// the worker runs, which would then wait for itself.
+//
+// -------------------------------------------------------------------------
+
+void SyncMemWriteBehind(void)
+{
+    if (WorkerRun)
+    {
+        DrainWrites();
+        InvalidateIndex();
+    }
+}
+
+// -------------------------------------------------------------------------
+// WaitMemWriteBehind()
+//
+// Wait for all queued writes to be applied, keeping the written word
+// index. Enough before only reading the model whilst the worker is
+// running, as reads leave the index consistent with memory.
+//
+// -------------------------------------------------------------------------
+
+void WaitMemWriteBehind(void)
+{
+    if (WorkerRun)
+    {
+        DrainWrites();
+    }
+}
+
+// -------------------------------------------------------------------------
+// MemWbWrite()
+//
+// Queue a write of the byte lanes of data enabled by be to the word
+// at addr, returning false, with nothing queued, if the worker thread
+// isn't running.
+//
+// -------------------------------------------------------------------------
+
+bool MemWbWrite(const uint64_t addr, const uint32_t data, const uint32_t be, const int le, const uint32_t node)
+{
+    pMemWbEntry_t entry;
+    pMemWbWord_t  word;
+    uint32_t      mask;
+    int           i;
+
+    if (!WorkerRun)
+    {
+        return false;
+    }
+
+    // Wait for room in the ring
+    if (RingHead - __atomic_load_n(&RingTail, __ATOMIC_ACQUIRE) == MEM_WB_RING_SIZE)
+    {
+        Stats.ring_full++;
+        WaitApplied(RingHead - MEM_WB_RING_SIZE + 1);
+    }
+
+    entry       = &Ring[RingHead & MEM_WB_RING_MASK];
+    mask        = WriteBytes(data, be, le, entry->bytes);
+
+    entry->addr = addr & ~3ULL;
+    entry->node = node;
+    entry->mask = mask;
+
+    __atomic_store_n(&RingHead, RingHead + 1, __ATOMIC_RELEASE);
+
+    Stats.queued++;
+
+    // Merge the written bytes into the word's index entry
+    word = IndexWord(entry->addr, node);
+
+    if (word->gen != IndexGen || word->addr != entry->addr || word->node != node)
+    {
+        word->gen  = IndexGen;
+        word->addr = entry->addr;
+        word->node = node;
+        word->mask = 0;
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        if (mask & (1U << i))
+        {
+            word->bytes[i] = entry->bytes[i];
+        }
+    }
+
+    word->mask |= mask;
+
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// MemWbRead()
+//
+// Read the byte lanes enabled by be of the word at addr from the
+// written word index, returning false if the worker thread isn't
+// running, or the bytes aren't all in the index. When false is
+// returned, all queued writes have been applied, and the model can
+// be read.
+//
+// -------------------------------------------------------------------------
+
+bool MemWbRead(const uint64_t addr, const uint32_t be, const int le, const uint32_t node, uint32_t* const data)
+{
+    pMemWbWord_t word;
+
+    if (!WorkerRun)
+    {
+        return false;
+    }
+
+    word = IndexWord(addr & ~3ULL, node);
+
+    if (word->gen == IndexGen && word->addr == (addr & ~3ULL) && word->node == node &&
+        ReadBytes(be, le, word->bytes, word->mask, data))
+    {
+        Stats.forwarded++;
+        return true;
+    }
+
+    DrainWrites();
+
+    return false;
+}
+
+#else
+
+int StartMemWriteBehind(void)
+{
+    printf("StartMemWriteBehind: ***Error --- worker thread not supported on this platform\n");
+    return MEM_BAD_STATUS;
+}
+
+void StopMemWriteBehind(void)
+{
+}
+
+void SyncMemWriteBehind(void)
+{
+}
+
+void WaitMemWriteBehind(void)
+{
+}
+
+bool MemWbWrite(const uint64_t addr, const uint32_t data, const uint32_t be, const int le, const uint32_t node)
+{
+    return false;
+}
+
+bool MemWbRead(const uint64_t addr, const uint32_t be, const int le, const uint32_t node, uint32_t* const data)
+{
+    return false;
+}
+
+#endif
+
+// -------------------------------------------------------------------------
+// GetMemWbStats()
+//
+// Return the write-behind statistics
+//
+// -------------------------------------------------------------------------
+
+void GetMemWbStats(MemWbStats_t* const stats)
+{
+    *stats = Stats;
+}
@@ -0,0 +1,54 @@
+//=====================================================================
+//
+// mem_wb.h                                           Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+//=====================================================================
+
+#ifndef _MEM_WB_H_
+#define _MEM_WB_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include "mem.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define MEM_WB_RING_SIZE        4096        // Queued write ring size (power of 2)
+#define MEM_WB_RING_MASK        (MEM_WB_RING_SIZE-1)
+
+#define MEM_WB_INDEX_SIZE       1024        // Written word index size (power of 2)
+#define MEM_WB_INDEX_MASK       (MEM_WB_INDEX_SIZE-1)
+
+#define MEM_WB_SPIN             256         // Spin wait polls before sleeping or yielding
+#define MEM_WB_POLL_NS          10000       // Worker sleep when ring has been empty a while
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef struct {
+    uint64_t  queued;               // Writes queued for the worker thread
+    uint64_t  forwarded;            // Reads returned from the written word index
+    uint64_t  drains;               // Reads that waited for the queued writes to be applied
+    uint64_t  ring_full;            // Writes that waited for space in the ring
+} MemWbStats_t, *pMemWbStats_t;
+
+// -------------------------------------------------------------------------
+// PROTOTYPES
+// -------------------------------------------------------------------------
+
+extern int      StartMemWriteBehind (void);
+extern void     StopMemWriteBehind  (void);
+extern void     SyncMemWriteBehind  (void);
+extern void     WaitMemWriteBehind  (void);
+extern void     GetMemWbStats       (MemWbStats_t* const stats);
+extern bool     MemWbWrite          (const uint64_t addr, const uint32_t data, const uint32_t be, const int le, const uint32_t node);
+extern bool     MemWbRead           (const uint64_t addr, const uint32_t be, const int le, const uint32_t node, uint32_t* const data);
+
+#endif
@@ -8,7 +8,11 @@
 //  Standard   : Verilog 2001
 // -----------------------------------------------------------------------------
 //  Description:
-//  This block defines a generic top level verilog wrapper around VProc
+//  This block defines a generic top level verilog wrapper around VProc.
+//  As well as the register style master interface, a small register window
+//  at BURST_BASE lets the host drive the memory model's burst read (rx) and
+//  burst write (tx) ports, with read burst data buffered for the host to
+//  read back one word per access.
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2021 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -31,8 +35,9 @@
 `timescale 1ns / 1ps
 
 module cpu
- #(parameter          BE_ADDR = 32'hAFFFFFF0,
-   parameter          NODE    = 0)
+ #(parameter          BE_ADDR    = 32'hAFFFFFF0,
+   parameter          BURST_BASE = 32'hAFFFFFE0,
+   parameter          NODE       = 0)
  (
     input             clk,
 
@@ -44,31 +49,86 @@ module cpu
     output            read,
     input      [31:0] readdata,
     input             readdatavalid,
-    
+
+    // Burst read master interface
+    input             rx_waitrequest,
+    output     [11:0] rx_burstcount,
+    output     [31:0] rx_address,
+    output reg        rx_read,
+    input      [31:0] rx_readdata,
+    input             rx_readdatavalid,
+
+    // Burst write master interface
+    input             tx_waitrequest,
+    output     [11:0] tx_burstcount,
+    output     [31:0] tx_address,
+    output reg        tx_write,
+    output     [31:0] tx_writedata,
+
     input             irq
 );
 
+// Burst register window offsets from BURST_BASE
+localparam            BURST_ADDR_OFFSET  = 4'h0;  // Start address of next burst
+localparam            BURST_LEN_OFFSET   = 4'h4;  // Words in next burst
+localparam            BURST_WDATA_OFFSET = 4'h8;  // Write: next word of a write burst
+localparam            BURST_RDATA_OFFSET = 4'hc;  // Write: start a read burst. Read: next word read
+
 reg         UpdateResponse;
 wire        Update;
 wire        WE;
+wire        RD;
 wire [31:0] nodenum = NODE;
 
+reg  [31:0] burst_addr;
+reg  [11:0] burst_len;
+
+// Read burst data, buffered until read by the host
+reg  [31:0] rx_buf [0:4095];
+reg  [11:0] rx_wptr;
+reg  [11:0] rx_rptr;
+
+wire        burst_sel;
+wire        burst_rdata_sel;
+wire        burst_stall;
+
 initial
 begin
   UpdateResponse  <= 1'b1;
   byteenable      <= 4'hf;
+  rx_read         <= 1'b0;
+  tx_write        <= 1'b0;
+  burst_addr      <= 32'h00000000;
+  burst_len       <= 12'h001;
+  rx_wptr         <= 12'h000;
+  rx_rptr         <= 12'h000;
 end
 
+assign burst_sel        = (address[31:4] == BURST_BASE[31:4]);
+assign burst_rdata_sel  = burst_sel & (address[3:0] == BURST_RDATA_OFFSET);
+
+// Hold off the host whilst a burst port is not ready
+assign burst_stall      = (tx_write & tx_waitrequest) | (rx_read & rx_waitrequest);
+
+// Reads of the burst window are not passed on to the memory
+assign read             = RD & ~burst_sel;
+
+assign rx_address       = burst_addr;
+assign rx_burstcount    = burst_len;
+assign tx_address       = burst_addr;
+assign tx_burstcount    = burst_len;
+assign tx_writedata     = writedata;
+
 
   VProc vp (
             .Clk                     (clk),
             .Addr                    (address),
             .WE                      (WE),
-            .RD                      (read),
+            .RD                      (RD),
             .DataOut                 (writedata),
-            .DataIn                  (readdata),
-            .WRAck                   (WE),
-            .RDAck                   (readdatavalid),
+            .DataIn                  (burst_rdata_sel ? rx_buf[rx_rptr]     : readdata),
+            .WRAck                   (WE & ~burst_stall),
+            .RDAck                   (burst_rdata_sel ? (rx_rptr != rx_wptr) : readdatavalid),
             .Interrupt               ({2'b00, irq}),
             .Update                  (Update),
             .UpdateResponse          (UpdateResponse),
@@ -78,11 +138,28 @@ end
 
 always @(Update)
 begin
+  tx_write             <= WE & burst_sel & (address[3:0] == BURST_WDATA_OFFSET);
+  rx_read              <= WE & burst_rdata_sel;
+
   if (WE == 1'b1 && address == BE_ADDR)
   begin
     byteenable         <= writedata[3:0];
     write              <= 1'b0;
   end
+  else if (WE == 1'b1 && burst_sel == 1'b1)
+  begin
+    if (address[3:0] == BURST_ADDR_OFFSET)
+    begin
+      burst_addr       <= writedata;
+    end
+
+    if (address[3:0] == BURST_LEN_OFFSET)
+    begin
+      burst_len        <= writedata[11:0];
+    end
+
+    write              <= 1'b0;
+  end
   else
   begin
     write              <= WE;
@@ -91,4 +168,24 @@ begin
   UpdateResponse = ~UpdateResponse;
 end
 
+// Buffer read burst data as it is returned, sampled away from the
+// rising edge on which the memory model updates it
+always @(negedge clk)
+begin
+  if (rx_readdatavalid == 1'b1)
+  begin
+    rx_buf[rx_wptr]    <= rx_readdata;
+    rx_wptr            <= rx_wptr + 12'h001;
+  end
+end
+
+// A buffered word is consumed when read by the host
+always @(posedge clk)
+begin
+  if (RD == 1'b1 && burst_rdata_sel == 1'b1 && rx_rptr != rx_wptr)
+  begin
+    rx_rptr            <= rx_rptr + 12'h001;
+  end
+end
+
 endmodule
\ No newline at end of file
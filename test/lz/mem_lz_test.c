@@ -0,0 +1,223 @@
+//=====================================================================
+//
+// mem_lz_test.c                                      Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Host test of the page compression codec (src/mem_lz.c). Zero,
+// random, repetitive and incompressible pages are compressed and
+// decompressed, and must round trip. Truncated, corrupted and random
+// compressed data is then fed to the decompressor, which must reject
+// truncated data, and never read or write outside its buffers. All
+// buffers are allocated at their exact sizes, so that the makefile's
+// asan target catches any access beyond them.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mem.h"
+#include "mem_lz.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define TEST_SEED           0x9e3779b97f4a7c15ULL
+#define TEST_PAGE_SIZE      TABLESIZE
+#define TEST_COMP_MAX       (2*TEST_PAGE_SIZE)
+#define TEST_CORRUPTIONS    2000
+#define TEST_GARBAGE        2000
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static uint64_t Rand = TEST_SEED;
+static int      Errors = 0;
+
+// -------------------------------------------------------------------------
+// NextRand()
+//
+// Return the next value of a xorshift pseudo-random sequence
+//
+// -------------------------------------------------------------------------
+
+static uint32_t NextRand(void)
+{
+    Rand ^= Rand << 13;
+    Rand ^= Rand >> 7;
+    Rand ^= Rand << 17;
+
+    return (uint32_t)Rand;
+}
+
+// -------------------------------------------------------------------------
+// Decompress()
+//
+// Decompress len bytes of comp, copied to a buffer of exactly len
+// bytes, into a buffer of exactly TEST_PAGE_SIZE bytes, copying the
+// result to page if not NULL. Returns the decompressor's status.
+//
+// -------------------------------------------------------------------------
+
+static int Decompress(const uint8_t* comp, const uint32_t len, uint8_t* page)
+{
+    uint8_t* src = malloc(len ? len : 1);
+    uint8_t* dst = malloc(TEST_PAGE_SIZE);
+    int      status;
+
+    memcpy(src, comp, len);
+
+    status = MemLzDecompress(src, len, dst, TEST_PAGE_SIZE);
+
+    if (page != NULL)
+    {
+        memcpy(page, dst, TEST_PAGE_SIZE);
+    }
+
+    free(src);
+    free(dst);
+
+    return status;
+}
+
+// -------------------------------------------------------------------------
+// CheckPage()
+//
+// Check that a page round trips through the codec, and that the
+// compressed data is rejected when truncated or corrupted. Returns
+// the compressed length.
+//
+// -------------------------------------------------------------------------
+
+static uint32_t CheckPage(const char* name, const uint8_t* page)
+{
+    static uint8_t comp[TEST_COMP_MAX];
+    static uint8_t out[TEST_PAGE_SIZE];
+    uint8_t*       small;
+    uint32_t       len, cut, idx, n;
+
+    if ((len = MemLzCompress(page, TEST_PAGE_SIZE, comp, TEST_COMP_MAX)) == 0)
+    {
+        printf("%s: ***Error --- failed to compress\n", name);
+        Errors++;
+        return 0;
+    }
+
+    if (Decompress(comp, len, out) != MEM_GOOD_STATUS || memcmp(out, page, TEST_PAGE_SIZE) != 0)
+    {
+        printf("%s: ***Error --- round trip mismatch\n", name);
+        Errors++;
+    }
+
+    // Compressing into too small a buffer must fail without writing past it
+    small = malloc(len - 1 ? len - 1 : 1);
+    if (MemLzCompress(page, TEST_PAGE_SIZE, small, len - 1) != 0)
+    {
+        printf("%s: ***Error --- compressed into %u bytes, smaller than %u\n", name, len - 1, len);
+        Errors++;
+    }
+    free(small);
+
+    // Every truncation must be rejected
+    for (cut = 0; cut < len; cut++)
+    {
+        if (Decompress(comp, cut, NULL) == MEM_GOOD_STATUS)
+        {
+            printf("%s: ***Error --- truncation to %u of %u bytes accepted\n", name, cut, len);
+            Errors++;
+            break;
+        }
+    }
+
+    // Corruptions may happen to decode to a page, but must stay in bounds
+    for (n = 0; n < TEST_CORRUPTIONS; n++)
+    {
+        idx        = NextRand() % len;
+        comp[idx] ^= (uint8_t)(1 + NextRand() % 255);
+
+        Decompress(comp, len, NULL);
+
+        comp[idx]  = 0;
+        MemLzCompress(page, TEST_PAGE_SIZE, comp, TEST_COMP_MAX);
+    }
+
+    printf("%-16s %5u bytes compressed\n", name, len);
+
+    return len;
+}
+
+// -------------------------------------------------------------------------
+// main()
+// -------------------------------------------------------------------------
+
+int main(void)
+{
+    static uint8_t page[TEST_PAGE_SIZE];
+    static uint8_t garbage[TEST_COMP_MAX];
+    uint32_t       idx, n, len;
+
+    // Zero page
+    memset(page, 0, TEST_PAGE_SIZE);
+    CheckPage("zero", page);
+
+    // Repeated short pattern, with occasional changes, for long matches
+    // and long literal runs
+    for (idx = 0; idx < TEST_PAGE_SIZE; idx++)
+    {
+        page[idx] = (uint8_t)("memory model "[idx % 13]);
+    }
+    for (idx = 0; idx < TEST_PAGE_SIZE; idx += 1 + NextRand() % 300)
+    {
+        page[idx] = (uint8_t)NextRand();
+    }
+    CheckPage("repetitive", page);
+
+    // Words holding their own address, as a typical initialised buffer
+    for (idx = 0; idx < TEST_PAGE_SIZE; idx += 4)
+    {
+        memcpy(page + idx, &idx, 4);
+    }
+    CheckPage("address", page);
+
+    // Random bytes, which do not compress
+    for (idx = 0; idx < TEST_PAGE_SIZE; idx++)
+    {
+        page[idx] = (uint8_t)NextRand();
+    }
+    if ((len = CheckPage("incompressible", page)) != 0 && len <= TEST_PAGE_SIZE)
+    {
+        printf("incompressible: ***Error --- random page compressed to %u bytes\n", len);
+        Errors++;
+    }
+
+    // Random data, with random lengths, fed straight to the decompressor
+    for (n = 0; n < TEST_GARBAGE; n++)
+    {
+        len = NextRand() % TEST_COMP_MAX;
+
+        for (idx = 0; idx < len; idx++)
+        {
+            garbage[idx] = (uint8_t)NextRand();
+        }
+
+        Decompress(garbage, len, NULL);
+    }
+
+    if (Errors)
+    {
+        printf("mem_lz_test: FAIL (%d errors)\n", Errors);
+        return 1;
+    }
+
+    printf("mem_lz_test: PASS\n");
+
+    return 0;
+}
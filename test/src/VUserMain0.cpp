@@ -151,6 +151,73 @@ extern "C" void VUserMain0()
         VPrint("Read word  0x%08x\n", read_word(addr2));
     }
     
+    // Write a block of words over the burst write port, and read it back over the burst read port
+    const uint32_t addr3     = 0x00010000;
+    const uint32_t blocklen  = 64;
+    uint32_t       wblock[blocklen], rblock[blocklen];
+
+    for (uint32_t idx = 0; idx < blocklen; idx++)
+    {
+        wblock[idx] = testdata1 ^ (idx * 0x01010101);
+    }
+
+    write_block(addr3, wblock, blocklen);
+    read_block(addr3, rblock, blocklen);
+
+    for (uint32_t idx = 0; idx < blocklen; idx++)
+    {
+        if (rblock[idx] != wblock[idx])
+        {
+            error |= 0x100;
+            VPrint("**Error: bad block read. Expected 0x%08x, got 0x%08x\n", wblock[idx], rblock[idx]);
+            break;
+        }
+    }
+
+    if (!(error & 0x100))
+    {
+        VPrint("Read block of %d words\n", blocklen);
+    }
+
+    // Queue byte writes into the block, with a word read back of each, and issue them together
+    uint32_t    qdata[4], qread[4];
+    mem_trans_t trans;
+
+    for (uint32_t idx = 0; idx < 4; idx++)
+    {
+        qdata[idx]  = (testdata4 + idx) << (idx * 8);
+
+        trans.type  = TRANS_WRITE;
+        trans.addr  = addr3 + idx*4 + idx;
+        trans.data  = &qdata[idx];
+        trans.be    = 1 << idx;
+        submit_trans(&trans);
+
+        trans.type  = TRANS_READ;
+        trans.addr  = addr3 + idx*4;
+        trans.data  = &qread[idx];
+        trans.be    = BE_WORD;
+        submit_trans(&trans);
+    }
+
+    complete_trans();
+
+    for (uint32_t idx = 0; idx < 4; idx++)
+    {
+        uint32_t expected = (wblock[idx] & ~(0xffU << (idx * 8))) | qdata[idx];
+
+        if (qread[idx] != expected)
+        {
+            error |= 0x200;
+            VPrint("**Error: bad queued read. Expected 0x%08x, got 0x%08x\n", expected, qread[idx]);
+        }
+    }
+
+    if (!(error & 0x200))
+    {
+        VPrint("Completed queued transactions\n");
+    }
+
     if (error)
     {
         VPrint("\n***FAIL***: exit code %d\n\n", error);
@@ -10,37 +10,77 @@
 
 #include "mem_vproc_api.h"
 
-void write_word(uint32_t addr, uint32_t data)
+// Byte enables currently set in the cpu wrapper
+static uint32_t    cur_be = BE_WORD;
+
+// Queued transactions, waiting for complete_trans()
+static mem_trans_t trans_q[MAX_QUEUED_TRANS];
+static int         num_queued = 0;
+
+// ------------------------------------------------------------
+// Set the byte enables for following accesses, only writing
+// the byte enable register if they have changed
+//
+static void set_be(uint32_t be)
+{
+    if (be != cur_be)
+    {
+        VWrite(BYTE_EN_ADDR, be, DELTA_UPDATE, node);
+        cur_be = be;
+    }
+}
+
+// ------------------------------------------------------------
+// Single word write and read, with byte enables, and data in
+// its byte lanes
+//
+static void write_be(uint32_t addr, uint32_t data, uint32_t be)
 {
+    set_be(be);
     VWrite(addr & ~0x3UL, data, NORMAL_UPDATE, node);
-    VTick(ACCESS_LEN, node);
 }
 
-void write_hword(uint32_t addr, uint32_t data)
+static uint32_t read_be(uint32_t addr, uint32_t be)
 {
-    VWrite(BYTE_EN_ADDR, (0x3 << (addr & 0x2)), DELTA_UPDATE, node);
+    uint32_t word;
 
-    VWrite(addr & ~0x3UL, data << ((addr & 0x2) * 8), NORMAL_UPDATE, node);
-    VTick(ACCESS_LEN, node);
+    set_be(be);
+    VRead(addr & ~0x3UL, &word, NORMAL_UPDATE, node);
 
-    VWrite(BYTE_EN_ADDR, 0xf, DELTA_UPDATE, node);
+    return word;
 }
 
-void write_byte(uint32_t addr, uint32_t data)
+// ------------------------------------------------------------
+// Set up the address and length of the next burst
+//
+static void setup_burst(uint32_t addr, uint32_t len)
+{
+    VWrite(BURST_ADDR_REG, addr & ~0x3UL, DELTA_UPDATE, node);
+    VWrite(BURST_LEN_REG,  len,           DELTA_UPDATE, node);
+}
+
+void write_word(uint32_t addr, uint32_t data)
 {
-    VWrite(BYTE_EN_ADDR, (0x1 << (addr & 0x3)), DELTA_UPDATE, node);
+    write_be(addr, data, BE_WORD);
+    VTick(ACCESS_LEN, node);
+}
 
-    VWrite(addr & ~0x3UL, data << ((addr & 0x3) * 8), NORMAL_UPDATE, node);
+void write_hword(uint32_t addr, uint32_t data)
+{
+    write_be(addr, data << ((addr & 0x2) * 8), 0x3 << (addr & 0x2));
     VTick(ACCESS_LEN, node);
+}
 
-    VWrite(BYTE_EN_ADDR, 0xf, DELTA_UPDATE, node);
+void write_byte(uint32_t addr, uint32_t data)
+{
+    write_be(addr, data << ((addr & 0x3) * 8), 0x1 << (addr & 0x3));
+    VTick(ACCESS_LEN, node);
 }
 
 uint32_t read_word(uint32_t addr)
 {
-    uint32_t word;
+    uint32_t word = read_be(addr, BE_WORD);
 
-    VRead(addr & ~0x3, &word, NORMAL_UPDATE, node);
     VTick(ACCESS_LEN, node);
 
     return word;
@@ -48,30 +88,129 @@ uint32_t read_word(uint32_t addr)
 
 uint32_t read_hword(uint32_t addr)
 {
-    uint32_t word;
+    uint32_t word = read_be(addr, 0x3 << (addr & 0x2));
 
-    VWrite(BYTE_EN_ADDR, (0x3 << (addr & 0x2)), DELTA_UPDATE, node);
+    VTick(ACCESS_LEN, node);
 
-    VRead(addr & ~0x3UL, &word, NORMAL_UPDATE, node);
+    return word >> ((addr & 0x2UL) * 8);
+}
 
-    VWrite(BYTE_EN_ADDR, 0xf, DELTA_UPDATE, node);
+uint32_t read_byte(uint32_t addr)
+{
+    uint32_t word = read_be(addr, 0x1 << (addr & 0x3));
 
     VTick(ACCESS_LEN, node);
 
-    return word >> ((addr & 0x2UL) * 8);
+    return word >> ((addr & 0x3UL) * 8);
 }
 
-uint32_t read_byte(uint32_t addr)
+// ------------------------------------------------------------
+// Write len words to memory from addr, using the memory model's
+// burst write port, at one word per clock cycle
+//
+void write_block(uint32_t addr, const uint32_t* data, uint32_t len)
 {
-    uint32_t word;
+    uint32_t chunk;
 
-    VWrite(BYTE_EN_ADDR, (1 << (addr & 0x3)), DELTA_UPDATE, node);
+    set_be(BE_WORD);
 
-    VRead(addr & ~0x3UL, &word, NORMAL_UPDATE, node);
+    while (len)
+    {
+        chunk = (len > MAX_BURST_LEN) ? MAX_BURST_LEN : len;
 
-    VWrite(BYTE_EN_ADDR, 0xf, DELTA_UPDATE, node);
+        setup_burst(addr, chunk);
 
-    VTick(ACCESS_LEN, node);
+        for (uint32_t idx = 0; idx < chunk; idx++)
+        {
+            VWrite(BURST_WDATA_REG, data[idx], NORMAL_UPDATE, node);
+        }
 
-    return word >> ((addr & 0x3UL) * 8);
-}
\ No newline at end of file
+        addr += chunk * 4;
+        data += chunk;
+        len  -= chunk;
+    }
+}
+
+// ------------------------------------------------------------
+// Read len words of memory from addr, using the memory model's
+// burst read port. Data is returned at one word per clock cycle,
+// after the port's initial latency.
+//
+void read_block(uint32_t addr, uint32_t* data, uint32_t len)
+{
+    uint32_t chunk;
+
+    set_be(BE_WORD);
+
+    while (len)
+    {
+        chunk = (len > MAX_BURST_LEN) ? MAX_BURST_LEN : len;
+
+        setup_burst(addr, chunk);
+
+        // Start the burst, then collect its data as it is returned
+        VWrite(BURST_RDATA_REG, 0, NORMAL_UPDATE, node);
+
+        for (uint32_t idx = 0; idx < chunk; idx++)
+        {
+            VRead(BURST_RDATA_REG, &data[idx], NORMAL_UPDATE, node);
+        }
+
+        addr += chunk * 4;
+        data += chunk;
+        len  -= chunk;
+    }
+}
+
+// ------------------------------------------------------------
+// Queue a transaction, to be issued by complete_trans().
+// Returns 0 if queued, or -1 if the queue is full.
+//
+int submit_trans(const mem_trans_t* trans)
+{
+    if (num_queued == MAX_QUEUED_TRANS)
+    {
+        VPrint("submit_trans: ***Error --- transaction queue full\n");
+        return -1;
+    }
+
+    trans_q[num_queued++] = *trans;
+
+    return 0;
+}
+
+// ------------------------------------------------------------
+// Issue all queued transactions, in order and back to back,
+// with read data returned to each read transaction's buffer.
+// Returns the number of transactions completed.
+//
+int complete_trans(void)
+{
+    int         count = num_queued;
+    mem_trans_t *t;
+
+    for (int idx = 0; idx < count; idx++)
+    {
+        t = &trans_q[idx];
+
+        switch (t->type)
+        {
+        case TRANS_WRITE:
+            write_be(t->addr, *t->data, t->be);
+            break;
+        case TRANS_READ:
+            *t->data = read_be(t->addr, t->be);
+            break;
+        case TRANS_BURST_WRITE:
+            write_block(t->addr, t->data, t->len);
+            break;
+        case TRANS_BURST_READ:
+            read_block(t->addr, t->data, t->len);
+            break;
+        }
+    }
+
+    num_queued = 0;
+
+    return count;
+}
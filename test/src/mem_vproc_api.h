@@ -29,6 +29,39 @@ extern "C" {
 #define BYTE_EN_ADDR                            0xAFFFFFF0
 #define HALT_ADDR                               0xAFFFFFF8
 
+// Burst register window in the cpu wrapper, driving the memory model's burst ports
+#define BURST_BASE_ADDR                         0xAFFFFFE0
+#define BURST_ADDR_REG                          (BURST_BASE_ADDR + 0x0)
+#define BURST_LEN_REG                           (BURST_BASE_ADDR + 0x4)
+#define BURST_WDATA_REG                         (BURST_BASE_ADDR + 0x8)
+#define BURST_RDATA_REG                         (BURST_BASE_ADDR + 0xc)
+
+// Longest single burst on the memory model's burst ports, in words
+#define MAX_BURST_LEN                           4095
+
+// Most transactions that can be queued before calling complete_trans()
+#define MAX_QUEUED_TRANS                        256
+
+#define BE_WORD                                 0xf
+
+// Transaction types
+typedef enum {
+    TRANS_WRITE,                                // Single word write, with byte enables
+    TRANS_READ,                                 // Single word read, with byte enables
+    TRANS_BURST_WRITE,                          // Block write of len words
+    TRANS_BURST_READ                            // Block read of len words
+} mem_trans_type_t;
+
+// A queued transaction. For single transfers, data points to the one
+// word to write or read (in its byte lanes), and len is ignored.
+typedef struct {
+    mem_trans_type_t    type;
+    uint32_t            addr;
+    uint32_t*           data;
+    uint32_t            len;
+    uint32_t            be;
+} mem_trans_t;
+
 extern int      node;
 
 extern void     write_word  (uint32_t addr, uint32_t data);
@@ -38,6 +71,12 @@ extern uint32_t read_word   (uint32_t addr);
 extern uint32_t read_hword  (uint32_t addr);
 extern uint32_t read_byte   (uint32_t addr);
 
+extern void     write_block (uint32_t addr, const uint32_t* data, uint32_t len);
+extern void     read_block  (uint32_t addr, uint32_t* data, uint32_t len);
+
+extern int      submit_trans   (const mem_trans_t* trans);
+extern int      complete_trans (void);
+
 #endif
 
 
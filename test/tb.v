@@ -36,6 +36,7 @@
 `define TIMEOUT_COUNT   400000
 
 `define BE_ADDR         32'hAFFFFFF0
+`define BURST_BASE      32'hAFFFFFE0
 `define HALT_ADDR       32'hAFFFFFF8
 
 module tb
@@ -58,6 +59,19 @@ wire           read;
 wire [31:0]    readdata;
 wire           readdatavalid;
 
+wire           rx_waitrequest;
+wire [11:0]    rx_burstcount;
+wire [31:0]    rx_address;
+wire           rx_read;
+wire [31:0]    rx_readdata;
+wire           rx_readdatavalid;
+
+wire           tx_waitrequest;
+wire [11:0]    tx_burstcount;
+wire [31:0]    tx_address;
+wire           tx_write;
+wire [31:0]    tx_writedata;
+
 // -----------------------------------------------
 // Initialisation, clock and reset
 // -----------------------------------------------
@@ -99,7 +113,7 @@ end
   // Virtual CPU
   // -----------------------------------------------
 
- cpu  #(.BE_ADDR(`BE_ADDR)) cpu
+ cpu  #(.BE_ADDR(`BE_ADDR), .BURST_BASE(`BURST_BASE)) cpu
  (
    .clk                     (clk),
 
@@ -111,6 +125,19 @@ end
    .readdata                (readdata),
    .readdatavalid           (readdatavalid),
 
+   .rx_waitrequest          (rx_waitrequest),
+   .rx_burstcount           (rx_burstcount),
+   .rx_address              (rx_address),
+   .rx_read                 (rx_read),
+   .rx_readdata             (rx_readdata),
+   .rx_readdatavalid        (rx_readdatavalid),
+
+   .tx_waitrequest          (tx_waitrequest),
+   .tx_burstcount           (tx_burstcount),
+   .tx_address              (tx_address),
+   .tx_write                (tx_write),
+   .tx_writedata            (tx_writedata),
+
    .irq                     (1'b0)
  );
 
@@ -131,18 +158,21 @@ end
     .readdata               (readdata),
     .readdatavalid          (readdatavalid),
 
-    .rx_waitrequest         (),
-    .rx_burstcount          (),
-    .rx_address             (),
-    .rx_read                (1'b0),
-    .rx_readdata            (),
-    .rx_readdatavalid       (),
-
-    .tx_waitrequest         (),
-    .tx_burstcount          (),
-    .tx_address             (),
-    .tx_write               (1'b0),
-    .tx_writedata           (),
+    .rx_waitrequest         (rx_waitrequest),
+    .rx_burstcount          (rx_burstcount),
+    .rx_address             (rx_address),
+    .rx_read                (rx_read),
+    .rx_readdata            (rx_readdata),
+    .rx_readdatavalid       (rx_readdatavalid),
+
+    .tx_waitrequest         (tx_waitrequest),
+    .tx_burstcount          (tx_burstcount),
+    .tx_address             (tx_address),
+    .tx_write               (tx_write),
+    .tx_writedata           (tx_writedata),
+`ifdef MEM_EN_TX_BYTEENABLE
+    .tx_byteenable          (byteenable),
+`endif
 
     .wr_port_valid          (1'b0),
     .wr_port_data           (),
@@ -0,0 +1,321 @@
+//=====================================================================
+//
+// mem_wb_test.c                                      Date: 2026/10/18
+//
+// Copyright (c) 2026 Simon Southwell
+//
+// Host test of the write-behind worker thread (src/mem_wb.c). A
+// pseudo-random mix of word, burst, byte enabled and fill accesses
+// is made through the DPI entry points of mem_model.c, first with
+// write-behind off and then with it on, to separate regions of
+// memory. The read data of the two runs must match. A run of
+// sequential writes, larger than the ring, then checks reads when
+// the ring has been full. Finally, dirty tracking, profiling,
+// uninitialised read checking and generators are turned on and off
+// with writes still queued, which the model must wait for. Build with
+// the makefile's tsan target to also check the worker for data races.
+//
+//=====================================================================
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mem_model.h"
+#include "mem_page.h"
+#include "mem_dirty.h"
+#include "mem_prof.h"
+#include "mem_uninit.h"
+#include "mem_gen.h"
+#include "mem_wb.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define TEST_SEED           88172645463325252ULL
+#define TEST_OPS            200000
+#define TEST_WB_OFFSET      0x10000000  // Base of the write-behind run's memory
+
+#define TEST_FULL_WORDS     (4*MEM_WB_RING_SIZE)
+#define TEST_FULL_BASE      0x20000000
+
+#define TEST_TOGGLE_ROUNDS  64
+#define TEST_TOGGLE_WORDS   1024        // Words written before each toggle
+#define TEST_TOGGLE_BASE    0x30000000
+#define TEST_GEN_BASE       0x40000000
+#define TEST_PROF_FILE      "mem_wb_test.prof"
+
+// -------------------------------------------------------------------------
+// STATICS
+// -------------------------------------------------------------------------
+
+static uint64_t Rand;
+
+// -------------------------------------------------------------------------
+// NextRand()
+//
+// Return the next value of a xorshift pseudo-random sequence
+//
+// -------------------------------------------------------------------------
+
+static uint32_t NextRand(void)
+{
+    Rand ^= Rand << 13;
+    Rand ^= Rand >> 7;
+    Rand ^= Rand << 17;
+
+    return (uint32_t)Rand;
+}
+
+// -------------------------------------------------------------------------
+// RunMix()
+//
+// Make a pseudo-random mix of accesses to memory from offset, and
+// return a hash of all the data read
+//
+// -------------------------------------------------------------------------
+
+static uint32_t RunMix(const uint32_t offset)
+{
+    uint32_t hash = 0;
+    uint32_t op, addr, be, value;
+    int      data[MEM_MODEL_MAX_BURST], ben[MEM_MODEL_MAX_BURST];
+    int      rdata, len, i;
+    long     n;
+
+    Rand = TEST_SEED;
+
+    for (n = 0; n < TEST_OPS; n++)
+    {
+        op    = NextRand() % 100;
+        addr  = (NextRand() % 8192) * 4;
+        addr += ((NextRand() % 4) == 0) ? 0x100000 * (NextRand() % 4) : 0;
+        addr += offset;
+        be    = NextRand() % 16;
+        value = NextRand();
+
+        if (op < 45)
+        {
+            MemWrite((int)addr, (int)value, (int)be);
+        }
+        else if (op < 85)
+        {
+            MemRead((int)addr, &rdata, (int)be);
+            hash = hash * 31 + (uint32_t)rdata;
+        }
+        else if (op < 92)
+        {
+            len = 1 + NextRand() % MEM_MODEL_MAX_BURST;
+
+            for (i = 0; i < len; i++)
+            {
+                data[i] = (int)NextRand();
+                ben[i]  = (int)(NextRand() % 16);
+            }
+
+            MemWriteBurst((int)addr, (int)(NextRand() % 3), len, 0, data, ben);
+        }
+        else if (op < 99)
+        {
+            len = 1 + NextRand() % MEM_MODEL_MAX_BURST;
+
+            MemReadBurst((int)addr, (int)(NextRand() % 3), len, (NextRand() % 2) ? 4 : 0, data);
+
+            for (i = 0; i < len; i++)
+            {
+                hash = hash * 31 + (uint32_t)data[i];
+            }
+        }
+        else
+        {
+            MemFillTask(MEM_MODEL_DEFAULT_NODE, (int)(addr & ~TABLEMASK), (int)value, 256);
+        }
+    }
+
+    return hash;
+}
+
+// -------------------------------------------------------------------------
+// RunFull()
+//
+// Write more words than the ring holds, then read them back,
+// returning the number of mismatches
+//
+// -------------------------------------------------------------------------
+
+static int RunFull(void)
+{
+    int errors = 0;
+    int rdata, i;
+
+    for (i = 0; i < TEST_FULL_WORDS; i++)
+    {
+        MemWrite(TEST_FULL_BASE + i*4, i ^ 0x5a5a5a5a, 0xf);
+    }
+
+    for (i = 0; i < TEST_FULL_WORDS; i++)
+    {
+        MemRead(TEST_FULL_BASE + i*4, &rdata, 0xf);
+
+        if (rdata != (i ^ 0x5a5a5a5a))
+        {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+// -------------------------------------------------------------------------
+// RunToggle()
+//
+// Turn dirty tracking, profiling, uninitialised read checking and
+// generators on and off just after queuing a run of writes, then read
+// back all the writes and generated words, returning the number of
+// mismatches
+//
+// -------------------------------------------------------------------------
+
+static int RunToggle(void)
+{
+    MemDirtyPage_t pages[4];
+    int            errors = 0;
+    int            rdata, r, i;
+    uint32_t       addr;
+
+    for (r = 0; r < TEST_TOGGLE_ROUNDS; r++)
+    {
+        for (i = 0; i < TEST_TOGGLE_WORDS; i++)
+        {
+            addr = TEST_TOGGLE_BASE + (r*TEST_TOGGLE_WORDS + i)*4;
+            MemWrite((int)addr, (int)(addr ^ 0xa5a5a5a5), 0xf);
+        }
+
+        switch (r % 4)
+        {
+        case 0:
+            SetDirtyTracking(MEM_MODEL_DEFAULT_NODE, (r & 4) ? MEM_DIRTY_SUBPAGE : MEM_DIRTY_PAGE);
+            ClearDirty(MEM_MODEL_DEFAULT_NODE);
+            break;
+
+        case 1:
+            SetDirtyTracking(MEM_MODEL_DEFAULT_NODE, MEM_DIRTY_OFF);
+            SetUninitCheck(MEM_MODEL_DEFAULT_NODE, MEM_UNINIT_TRACK);
+            break;
+
+        case 2:
+            if (StartMemProfile(TEST_PROF_FILE, MEM_PROF_BINARY, MEM_PROF_ACCESSES, 1000) != MEM_GOOD_STATUS)
+            {
+                errors++;
+            }
+            SetUninitCheck(MEM_MODEL_DEFAULT_NODE, MEM_UNINIT_OFF);
+            break;
+
+        case 3:
+            StopMemProfile();
+            ClearMemGenerators(MEM_MODEL_DEFAULT_NODE);
+            if (AddMemGenerator(MEM_MODEL_DEFAULT_NODE, TEST_GEN_BASE, 0x100000, MEM_GEN_ADDRESS, 0, MEM_MODEL_DEFAULT_ENDIAN) != MEM_GOOD_STATUS)
+            {
+                errors++;
+            }
+            break;
+        }
+
+        // Read a generated word with writes still queued from the next round's start
+        addr = TEST_GEN_BASE + (r * 0x1004) % 0x100000;
+        MemRead((int)addr, &rdata, 0xf);
+
+        if (r >= 3 && (uint32_t)rdata != addr)
+        {
+            errors++;
+        }
+    }
+
+    // Writes queued before tracking is turned on must not be marked dirty
+    SetDirtyTracking(MEM_MODEL_DEFAULT_NODE, MEM_DIRTY_OFF);
+
+    for (i = 0; i < TEST_TOGGLE_WORDS; i++)
+    {
+        MemWrite(TEST_TOGGLE_BASE + i*4, (int)((TEST_TOGGLE_BASE + i*4) ^ 0xa5a5a5a5), 0xf);
+    }
+
+    SetDirtyTracking(MEM_MODEL_DEFAULT_NODE, MEM_DIRTY_PAGE);
+
+    if (GetDirtyPages(MEM_MODEL_DEFAULT_NODE, pages, 4) != 0)
+    {
+        errors++;
+    }
+
+    // ... but those queued after it must
+    MemWrite(TEST_TOGGLE_BASE, (int)(TEST_TOGGLE_BASE ^ 0xa5a5a5a5), 0xf);
+
+    if (GetDirtyPages(MEM_MODEL_DEFAULT_NODE, pages, 4) != 1 || pages[0].addr != TEST_TOGGLE_BASE)
+    {
+        errors++;
+    }
+
+    SetDirtyTracking(MEM_MODEL_DEFAULT_NODE, MEM_DIRTY_OFF);
+    ClearMemGenerators(MEM_MODEL_DEFAULT_NODE);
+    remove(TEST_PROF_FILE);
+
+    for (i = 0; i < TEST_TOGGLE_ROUNDS*TEST_TOGGLE_WORDS; i++)
+    {
+        addr = TEST_TOGGLE_BASE + i*4;
+        MemRead((int)addr, &rdata, 0xf);
+
+        if ((uint32_t)rdata != (addr ^ 0xa5a5a5a5))
+        {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+// -------------------------------------------------------------------------
+// main()
+// -------------------------------------------------------------------------
+
+int main(void)
+{
+    MemWbStats_t stats;
+    MemStats_t   mstats;
+    uint32_t     sync_hash, wb_hash;
+    int          errors;
+
+    sync_hash = RunMix(0);
+
+    if (StartMemWriteBehind() != MEM_GOOD_STATUS)
+    {
+        return 1;
+    }
+
+    wb_hash = RunMix(TEST_WB_OFFSET);
+    errors  = RunFull();
+    errors += RunToggle();
+
+    // Must be consistent with the worker still running
+    GetMemStats(&mstats);
+    GetMemWbStats(&stats);
+
+    StopMemWriteBehind();
+
+    printf("queued %llu, forwarded %llu, drains %llu, ring full %llu, resident pages %llu\n",
+           (long long unsigned)stats.queued, (long long unsigned)stats.forwarded,
+           (long long unsigned)stats.drains, (long long unsigned)stats.ring_full,
+           (long long unsigned)mstats.resident_pages);
+
+    if (wb_hash != sync_hash || errors)
+    {
+        printf("mem_wb_test: FAIL (read hash %08x, expected %08x, %d read errors)\n", wb_hash, sync_hash, errors);
+        return 1;
+    }
+
+    printf("mem_wb_test: PASS\n");
+
+    return 0;
+}